@@ -12,42 +12,35 @@
 #include "../src/sizes.h"
 #include "assert.h"
 
-// Clock generation function
-void clock_gen(sc_signal<bool>& clk, int period) {
-    while (true) {
-        clk.write(false);
-        wait(period / 2, SC_NS);
-        clk.write(true);
-        wait(period / 2, SC_NS);
-    }
-}
+// Strobes seen in answer to one tick
+#define S_LOAD_TX   0x001
+#define S_LOAD_TX2  0x002
+#define S_TX_START  0x004
+#define S_TX_DATA   0x008
+#define S_TX_PARITY 0x010
+#define S_TX_STOP   0x020
+#define S_TX_END    0x040
+#define S_RX_START  0x080
+#define S_RX_DATA   0x100
+#define S_RX_PARITY 0x200
+#define S_RX_STOP   0x400
 
-void run_instruction (controller& ctrl, sc_time& current_time, const sc_time& cycle_time, const std::string& detail, int n){
-    std::cout << detail << std::endl;
-    std::cout << "Instruction Cycle start time -" << current_time <<std::endl;
-    for(int i = 0; i < n; ++ i){
-        sc_start(2*cycle_time);
-        current_time += 2 * cycle_time;
-    }
-}
 // Test controller module
 int sc_main(int argc, char* argv[]) {
 
-    sc_time current_time = SC_ZERO_TIME;
-    sc_time cycle_time(CYCLE_LENGTH, SC_NS);
-    
-    sc_clock clk("clk", CYCLE_LENGTH);
+    sc_clock clk("clk", CYCLE_LENGTH, SC_NS);
     // Create signals
-    sc_signal<bool> clk, rst;
+    sc_signal<bool> rst;
     sc_signal<bool> load_tx, tx_start, tx_data, tx_parity, tx_stop;
-    sc_signal<bool> rx_start, rx_data, rx_parity, rx_stop, error_handle;
-    sc_signal<bool> tx_buffer_full, rx_buffer_empty;
+    sc_signal<bool> rx_start, rx_data, rx_parity, rx_stop;
+    sc_signal<bool> tx_buffer_full, tx_buffer_empty, rx_buffer_empty, tx_ready;
+    sc_signal<bool> tx_tick, rx_tick, rx_bit, cts;
     sc_signal<bool> parity_error, framing_error, overrun_error;
     sc_signal<bool> start, mem_we, rx_in, parity_enabled, parity_even;
-    sc_signal<bool> load_tx2, rx_read;
-    //NEED Inputs
-    sc_bv<DATA_W> data in;
-    sc_bv<DATA_W> data_out;
+    sc_signal<bool> load_tx2, de, tx_end;
+    sc_signal<sc_uint<4>> data_bits, de_guard;
+    sc_signal<sc_uint<2>> stop_bits;
+
     // Instantiate controller
     controller ctrl("controller");
     ctrl.clk(clk);
@@ -64,17 +57,26 @@ int sc_main(int argc, char* argv[]) {
     ctrl.rx_data(rx_data);
     ctrl.rx_parity(rx_parity);
     ctrl.rx_stop(rx_stop);
-    ctrl.rx_read(rx_read);
-    ctrl.error_handle(error_handle);
+    ctrl.de(de);
+    ctrl.tx_end(tx_end);
     ctrl.tx_buffer_full(tx_buffer_full);
+    ctrl.tx_buffer_empty(tx_buffer_empty);
     ctrl.rx_buffer_empty(rx_buffer_empty);
+    ctrl.tx_ready(tx_ready);
+    ctrl.tx_tick(tx_tick);
+    ctrl.rx_tick(rx_tick);
+    ctrl.rx_bit(rx_bit);
+    ctrl.cts(cts);
     ctrl.rx_in(rx_in);
     ctrl.parity_error(parity_error);
     ctrl.framing_error(framing_error);
     ctrl.overrun_error(overrun_error);
-    ctrl.data_in(data_in);
-    ctrl.data_out(data_out);
-    
+    ctrl.parity_enabled(parity_enabled);
+    ctrl.parity_even(parity_even);
+    ctrl.data_bits(data_bits);
+    ctrl.stop_bits(stop_bits);
+    ctrl.de_guard(de_guard);
+
     // Create trace file
     sc_trace_file *tf = sc_create_vcd_trace_file("controller_trace");
     sc_trace(tf, clk, "clk");
@@ -91,142 +93,181 @@ int sc_main(int argc, char* argv[]) {
     sc_trace(tf, rx_data, "rx_data");
     sc_trace(tf, rx_parity, "rx_parity");
     sc_trace(tf, rx_stop, "rx_stop");
-    sc_trace(tf,rx_read, "rx_read");
-    sc_trace(tf, error_handle, "error_handle");
     sc_trace(tf, tx_buffer_full, "tx_buffer_full");
     sc_trace(tf, rx_buffer_empty, "rx_buffer_empty");
+    sc_trace(tf, tx_ready, "tx_ready");
     sc_trace(tf, parity_error, "parity_error");
     sc_trace(tf, framing_error, "framing_error");
     sc_trace(tf, overrun_error, "overrun_error");
-    
+
+    // One protocol loop iteration of the controller threads
+    const int ITER_CYCLES = UART_SINGLE_CYCLE ? 1 : 2;
+
+    // Collect the strobes that are high on any clock
+    auto sample = [&]() -> unsigned {
+        unsigned seen = 0;
+        seen |= load_tx.read() ? S_LOAD_TX : 0;
+        seen |= load_tx2.read() ? S_LOAD_TX2 : 0;
+        seen |= tx_start.read() ? S_TX_START : 0;
+        seen |= tx_data.read() ? S_TX_DATA : 0;
+        seen |= tx_parity.read() ? S_TX_PARITY : 0;
+        seen |= tx_stop.read() ? S_TX_STOP : 0;
+        seen |= tx_end.read() ? S_TX_END : 0;
+        seen |= rx_start.read() ? S_RX_START : 0;
+        seen |= rx_data.read() ? S_RX_DATA : 0;
+        seen |= rx_parity.read() ? S_RX_PARITY : 0;
+        seen |= rx_stop.read() ? S_RX_STOP : 0;
+        return seen;
+    };
+
+    // Run for a number of loop iterations with no tick
+    auto idle = [&](int iterations) -> unsigned {
+        unsigned seen = 0;
+        for (int i = 0; i < iterations * ITER_CYCLES; i++) {
+            sc_start(CYCLE_LENGTH, SC_NS);
+            seen |= sample();
+        }
+        return seen;
+    };
+
+    // One bit period: the tick is high for a single loop iteration, as
+    // the baud generator drives it, and the rest of the period is quiet.
+    // Returns the strobes the controller raised for it.
+    auto bit_period = [&](sc_signal<bool>& tick, int iterations) -> unsigned {
+        tick.write(true);
+        unsigned seen = idle(1);
+        tick.write(false);
+        return seen | idle(iterations - 1);
+    };
+
     // Initialize signals
-    rst.write(true);
-    tx_buffer_full.write(true)
-    rx_buffer_empty.write(false);
-    parity_error.write(true);
-    framing_error.write(false);
-    overrun_error.write(false);
-    ctrl.reset_control_clear_regs(); 
-    
-    run_instruction(ctrl,current_time,cycle_time,"RESETTING INITIALIZE VARIABLES", 1);
-    std::cout << "TEST 1: RESET" << std::endl;
-    if(ctrl.test_reset_controller() == false)std::cout << "RESET FAILED" << std::endl;
-    //Clock cycle
-    
-    run_instruction(ctrl, current_time, cycle_time, "TEST 2 testing starting states of TX & RX", 1); 
-    std::cout << "TEST 2: FSM SEQUENCE" << std::endl; 
-    mem_we.write(true);
-    start.write(true);
-    ctrl.controller_fsm();
-    if(assert(tx_next_state == LOAD_TX2))std::cout  <<"TEST 2: FAILED mem_we[true] would cause FSM Logic to return" << std::endl;
-    mem_we.write(false);
+    rst.write(false);
     start.write(false);
-    run_instruction(ctrl, current_time,cycle_time, "TEST 3 FSM SEQUENCE", 1);
-    std::cout << "TEST 3: FSM SEQUENCE | tx_buffer_full:true | rx_buffer_empty:true | parity_error:false | framing_error: false | overrun_error: false" << std::endl; 
-    tx_buffer_full.write(true);
+    mem_we.write(false);
+    tx_tick.write(false);
+    rx_tick.write(false);
+    rx_bit.write(true);
+    rx_in.write(true);
+    cts.write(true);
+    tx_buffer_full.write(false);
+    tx_buffer_empty.write(true);
+    tx_ready.write(false);
     rx_buffer_empty.write(true);
-    rx_in.write(false);
     parity_error.write(false);
     framing_error.write(false);
     overrun_error.write(false);
-    data_bits.write(8); 
-    stop_bits.write(2);
-    parity_enabled.write(false); 
-    parity_even.write(false); 
-    ctrl.read_inputs();
-    ctrl.controller_fsm();
-    if(!assert(tx_next_state == TX_IDLE && rx_buffer_empty == RX_IDLE))std::cout << "TEST 3: FAILED | check tx_next_state and rx_next_state" << std::endl;
-    run_instruction(ctrl, current_time, cycle_time, "TEST 4 FSM SEQUENCE", 1); 
-//Clock cycle
-    std::cout << "TEST 4: FSM SEQUENCE" << std::endl; 
-    tx_buffer_full.write(false);
-    rx_in.write(true); 
-    ctrl.read_inputs();
-    ctrl.controller_fsm();
-    if(!assert(tx_next_state == LOAD_TX2 && out_load_tx == true && out_rx_start == true && rx_next_state == RX_START_BIT)std::cout << "TEST 4: FAILED Output: tx_next_state:" << tx_next_state << " |out_load_tx: " << out_load_tx << std::endl;
-    run_instruction(ctrl,current_time, cycle_time, "TEST 5: FSM SEQUENCE", 1);
-    //Clock cycle
-    std::cout << "TEST 5: FSM SEQUENCE" << std::endl;
-    ctrl.controller_fsm();
-    if(!assert(tx_next_state == TX_DATA_BITS && out_tx_start == true && tx_bit_counter == 0 && out_rx_start == true && rx_next_state == RX_DATA_BITS && rx_bit_counter = 0))std::cout << "TEST 5 FAILED" << std::endl;
-    std::cout << "TEST 6: FSM SEQUENCE" << std::endl;
-    ctrl.controller_fsm();
-    if(!assert(tx_bit_counter == 1  && tx_next_state == TX_DATA_BITS)std::cout << "*TX LOGIC FAILED*" << std::endl;
-    if(!assert(rx_bit_counter == 1 && rx_next_state == RX_DATA_BITS))std::cout <<"*RX LOGIC FAILED*" << std::endl;
-    run_instruction(ctrl,current_time,cycle_time, "TEST 6: FSM SEQUENCE", 1);
-    //Clock Cycle
-    std::cout << "TEST 7: FSM SEQUENCE Skip iteration of data_bits" << std::endl;
-    tx_bit_counter.write(8);
-    rx_bit_counter.write(2);
-    
-    ctrl.controller_fsm();
-    if(!assert(tx_next_state == TX_STOP_BIT))std::cout << "TX LOGIC FAILED | TEST 7" << std::endl;
-    if(!assert(rx_next_state == RX_STOP_BIT))std::cout << "RX LOGIC FAILED | TEST 7" << std::endl; 
-    run_instruction(ctrl, current_time, cycle_time, "TEST 7: FSM SEQUENCE", 1);
-    //Clock Cycle
-    std::cout << "TEST 8: FSM SEQUENCE" << std::endl; 
-    ctrl.controller_fsm();
-    if(!assert(out_tx_stop == true && tx_next_state == TX_IDLE && tx_done == false))std::cout << "TEST 8 TX LOGIC FAILED" << std::endl;
-    if(!assert(rx_next_state == RX_IDLE && out_rx_read == true && rx_done == true))std::cout << "TEST 8 RX LOGIC FAILED" << std::endl;
-    run_instruction(ctrl, current_time,cycle_time, "TEST 8: FSM SEQUENCE", 1);
-    //Clock Cycle
-    std::cout << "TEST 9: FSM SEQUENCE[All Data Reset][Errors Enabled]" << std::endl;
-    ctrl.reset_control_clear_regs()
-    start.write(false);
-    mem_we.write(false);
-    tx_buffer_full.write(false);
-    rx_buffer_empty.write(true);
-    rx_in.write(true);
-    parity_error.write(true);
-    framing_error.write(true); 
-    overrun_error.write(true);
-    parity_enabled.write(true);
-    parity_even.write(true);
-    data_bits.write(5);
-    stop_bits.write(1); 
-    ctrl.read_inputs();
-    run_instruction(ctrl, current_time, cycle_time, "TEST 9: FSM_SEQUENCE", 1);
-    //clock cycle
-    ctrl.controller_fsm(); 
-    if(!assert(out_load_tx == true && tx_new_state == LOAD_TX2))std::cout << "TEST 9: TX LOGIC FAILED" << std::endl;
-    if(!assert(out_rx_start == true && rx_next_state == RX_START_BIT)) std::cout<< "TEST 9: RX LOGIC FAILED" << std:endl;
-    run_instruction(ctrl, current_time,cycle_time, "TEST 10: FSM sequence",1);
-    //Clock Cycle
-    std::cout <<"TEST 10: FSM SEQUENCE" << std::endl;
-    ctrl.controller_fsm(); 
-    if(!assert(out_load_tx2 == true && tx_next_state == TX_START_BIT))std::cout << "TEST 10: TX LOGIC FAILED" << std::endl;
-    if(!assert(rx_next_state ==  RX_DATA_BITS && rx_bit_counter == 0 && out_rx_start == true))std::cout << "TEST 10: RX LOGIC FAILED" << std::endl;
-    run_instruction(ctrl, current_time, cycle_time, "TEST 11:FSM Sequence", 1);
-    //clock cycle
-
-    std::cout <<"TEST 11: FSM SEQUENCE" << std::endl;
-    ctrl.controller_fsm();
-    if(!assert(out_tx_start == true && tx_next_state == TX_DATA_BITS && tx_bit_counter == 0))std::cout << "TEST 11: TX Logic FAILED" << std::endl;
-    if(!assert(rx_next_state == RX_PARITY_CHECK))std::cout << "TEST 11: RX LOGIC FAILED" << std::endl;
-    run_instruction(ctrl, current_time, cycle_time, "TEST 12:FSM sequence",1);
-//clock cycle
-    std::cout <<"TEST 12: FSM SEQUENCE" << std::endl;
-    ctrl.controller_fsm();
-    if(!assert(tx_next_state == TX_PARITY_BIT)))std::cout << "TEST 12: TX LOGIC FAILED" << std::endl;
-
-    if(!assert(out_rx_parity  == true && rx_next_state == ERROR_HANDLING))std::cout << "TEST 12: RX LOGIC FAILED" << std::endl;
-    run_instruction(ctrl, current_time, cycle_time, "TEST 13: FSM SEQUENCE",1);
-    //clock cycle
-
-    std::cout <<"TEST 13: FSM SEQUENCE" << std::endl;
-    ctrl.controller_fsm();
-    if(!assert(out_tx_parity == true && tx_next_state == TX_STOP_BIT))std::cout << "TEST 13: TX LOGIC FAILED" << std::endl;
-
-    if(!assert(out_error_handle = true && rx_next_state == RX_IDLE))std::cout << "TEST 13: RX LOGIC FAILED" << std::endl;
-    run_instruction(ctrl, current_time, cycle_time, "14[FINAL TEST]", 1); 
-    //clock cycle
-    std::cout <<"TEST 14 [FINAL TESTING]" << std::endl; 
-
-    if(!assert(out_tx_stop == true && tx_next_state == TX_IDLE && tx_done == true));
-    run_instruction(ctrl, current_time, cycle_time, "END OF TESTING", 1);
+    parity_enabled.write(false);
+    parity_even.write(false);
+    data_bits.write(8);
+    stop_bits.write(1);
+    de_guard.write(2);
+
+    // TEST 1: reset
+    std::cout << "TEST 1: RESET" << std::endl;
+    idle(2);
+    assert(sample() == 0 && !de.read() && "Strobes must be low in reset");
+    rst.write(true);
+    assert(idle(8) == 0 && !de.read() && "Idle with an empty ring");
+    std::cout << "TEST 1 passed" << std::endl;
+
+    // TEST 2: the FSM only moves on tx_tick. The fractional baud
+    // generator stretches some bit periods by an iteration, so the
+    // ticks come at uneven spacing.
+    std::cout << "TEST 2: TX FSM ADVANCES ON TX_TICK ONLY" << std::endl;
+    tx_buffer_empty.write(false);
+    assert(idle(20) == 0 && "Load without a tick");
+    assert(bit_period(tx_tick, 4) == S_LOAD_TX && "First tick fetches the byte");
+    assert(idle(13) == 0 && "load_tx2 without a tick");
+    assert(bit_period(tx_tick, 5) == 0 && "Memory read gets a bit period");
+    assert(!de.read() && "Driver on before there is a frame");
+    std::cout << "TEST 2 passed" << std::endl;
+
+    // TEST 3: RS-485 lead. The driver goes on with load_tx2, one bit
+    // period ahead of the start bit.
+    std::cout << "TEST 3: DE LEAD" << std::endl;
+    assert(bit_period(tx_tick, 4) == S_LOAD_TX2 && "Second tick latches the byte");
+    assert(de.read() && "Driver must be on a bit period before the start bit");
+    tx_ready.write(true);
+    tx_buffer_empty.write(true);
+    assert(bit_period(tx_tick, 5) == S_TX_START && "Start bit after the lead");
+    std::cout << "TEST 3 passed" << std::endl;
+
+    // TEST 4: prefetch handshake. The next byte is fetched while the
+    // data bits shift, load_tx on the first bit and load_tx2 two bits
+    // later, and a prefetched byte follows the stop bit directly.
+    std::cout << "TEST 4: PREFETCH HANDSHAKE" << std::endl;
+    tx_ready.write(false);
+    tx_buffer_empty.write(false);
+    assert(bit_period(tx_tick, 4) == (S_TX_DATA | S_LOAD_TX) && "Fetch on the first data bit");
+    assert(bit_period(tx_tick, 5) == S_TX_DATA);
+    assert(bit_period(tx_tick, 4) == (S_TX_DATA | S_LOAD_TX2) && "Latch on the third data bit");
+    tx_ready.write(true);
+    tx_buffer_empty.write(true);
+    for (int i = 3; i < 8; i++) {
+        assert(bit_period(tx_tick, 4 + (i & 1)) == S_TX_DATA);
+    }
+    assert(bit_period(tx_tick, 4) == S_TX_STOP);
+    assert(bit_period(tx_tick, 4) == (S_TX_START | S_TX_END) && "Back-to-back start bit");
+    std::cout << "TEST 4 passed" << std::endl;
+
+    // TEST 5: CTS gating. A frame that started runs to the end, and the
+    // next one waits for CTS even with a byte prefetched.
+    std::cout << "TEST 5: CTS GATING" << std::endl;
+    cts.write(false);
+    for (int i = 0; i < 8; i++) {
+        assert((bit_period(tx_tick, 4) & S_TX_DATA) && "Frame in progress stops for CTS");
+    }
+    assert(bit_period(tx_tick, 4) == S_TX_STOP);
+    assert(bit_period(tx_tick, 4) == S_TX_END && "Start bit while CTS is down");
+    for (int i = 0; i < 4; i++) {
+        assert(bit_period(tx_tick, 4) == 0 && "Start bit while CTS is down");
+    }
+    std::cout << "TEST 5 passed" << std::endl;
+
+    // TEST 6: RS-485 guard. The driver stays on for de_guard bit
+    // periods after the last stop bit, then turns the bus around.
+    std::cout << "TEST 6: DE GUARD" << std::endl;
+    assert(!de.read() && "Guard time over while CTS held the frame");
+    tx_ready.write(false);
+    cts.write(true);
+    tx_buffer_empty.write(false);
+    bit_period(tx_tick, 4);             // load_tx
+    bit_period(tx_tick, 4);             // load wait
+    bit_period(tx_tick, 4);             // load_tx2, driver on
+    tx_buffer_empty.write(true);
+    assert(bit_period(tx_tick, 4) == S_TX_START);
+    tx_ready.write(false);
+    for (int i = 0; i < 8; i++) {
+        bit_period(tx_tick, 4);
+    }
+    assert(bit_period(tx_tick, 4) == S_TX_STOP);
+    assert(de.read());
+    assert(bit_period(tx_tick, 4) == S_TX_END);
+    assert(de.read() && "Guard period 1");
+    bit_period(tx_tick, 4);
+    assert(de.read() && "Guard period 2");
+    assert(idle(12) == 0 && de.read() && "Guard only counts on ticks");
+    bit_period(tx_tick, 4);
+    assert(!de.read() && "Driver left on after the guard time");
+    std::cout << "TEST 6 passed" << std::endl;
+
+    // TEST 7: one RX frame, 8N1, from the sampler's ticks
+    std::cout << "TEST 7: RX FRAME" << std::endl;
+    rx_bit.write(false);
+    assert(bit_period(rx_tick, 4) == S_RX_START);
+    for (int i = 0; i < 8; i++) {
+        rx_bit.write((0x5A >> i) & 1);
+        assert(bit_period(rx_tick, 4) == S_RX_DATA);
+    }
+    rx_bit.write(true);
+    assert(bit_period(rx_tick, 4) == S_RX_STOP && "Good stop bit");
+    rx_bit.write(false);
+    assert(bit_period(rx_tick, 4) == S_RX_START && "Next frame starts from idle");
+    std::cout << "TEST 7 passed" << std::endl;
+
     // Close trace file
     sc_close_vcd_trace_file(tf);
-    
+
     std::cout << "UART Controller Simulation Complete" << std::endl;
     return 0;
 }
@@ -45,13 +45,30 @@ void run_instruction(sc_time& current_time,
 int sc_main(int argc, char* argv[]) {
     // === Signals ===
     sc_signal<bool> clk, rst;
-    sc_signal<sc_uint<DATA_W>> data_in, data_out;
+    sc_signal<sc_uint<HOST_DATA_W>> data_in, data_out;
+    sc_signal<sc_uint<HOST_LANES>> byte_enable, byte_valid;
+    sc_signal<bool> burst;
     sc_signal<sc_uint<ADDR_W>> addr;
     sc_signal<bool> chip_select, read_write, write_enable;
-    sc_signal<sc_uint<DATA_W>> dp_data_in, dp_data_out;
-    sc_signal<sc_uint<ADDR_W>> dp_addr;
+    sc_signal<sc_uint<RX_ENTRY_W>> dp_data_in;
+    sc_signal<sc_uint<DATA_W>> dp_data_out;
+    sc_signal<sc_uint<ADDR_W>> dp_addr, tx_fetch_addr;
     sc_signal<bool> dp_write_enable;
     sc_signal<bool> tx_buffer_full, rx_buffer_empty, error_indicator;
+    sc_signal<sc_uint<4>> int_id;
+    sc_signal<bool> rx_timeout, match_pending;
+    sc_signal<sc_uint<RX_PTR_W>> match_index;
+    sc_signal<bool> ts_tx_event, tx_idle;
+    sc_signal<sc_uint<32>> dp_ts_data, ts_count;
+    sc_signal<sc_uint<TX_PTR_W>> tx_head, tx_tail;
+    sc_signal<sc_uint<RX_PTR_W>> rx_head, rx_tail;
+    sc_signal<sc_uint<DATA_W>> cfg_line_control, cfg_fifo_control, cfg_rx_control;
+    sc_signal<sc_uint<DATA_W>> cfg_modem_control, cfg_rts_threshold, cfg_int_enable;
+    sc_signal<sc_uint<DATA_W>> cfg_rs485_control, cfg_crc_control, cfg_framing_control;
+    sc_signal<sc_uint<DATA_W>> cfg_match_char;
+    sc_signal<sc_uint<32>> tx_crc, rx_crc;
+    sc_signal<sc_uint<16>> cfg_baud_divisor, cfg_station;
+    sc_signal<sc_uint<8>> cfg_baud_fraction;
 
     // === Instantiate DUT ===
     memory_map mem("memory_map");
@@ -63,13 +80,44 @@ int sc_main(int argc, char* argv[]) {
     mem.chip_select(chip_select);
     mem.read_write(read_write);
     mem.write_enable(write_enable);
+    mem.byte_enable(byte_enable);
+    mem.burst(burst);
+    mem.byte_valid(byte_valid);
     mem.dp_data_in(dp_data_in);
     mem.dp_data_out(dp_data_out);
     mem.dp_addr(dp_addr);
+    mem.tx_fetch_addr(tx_fetch_addr);
     mem.dp_write_enable(dp_write_enable);
+    mem.dp_ts_data(dp_ts_data);
+    mem.ts_count(ts_count);
     mem.tx_buffer_full(tx_buffer_full);
     mem.rx_buffer_empty(rx_buffer_empty);
     mem.error_indicator(error_indicator);
+    mem.int_id(int_id);
+    mem.rx_timeout(rx_timeout);
+    mem.tx_crc(tx_crc);
+    mem.rx_crc(rx_crc);
+    mem.match_pending(match_pending);
+    mem.match_index(match_index);
+    mem.ts_tx_event(ts_tx_event);
+    mem.tx_idle(tx_idle);
+    mem.tx_head(tx_head);
+    mem.rx_tail(rx_tail);
+    mem.tx_tail(tx_tail);
+    mem.rx_head(rx_head);
+    mem.cfg_line_control(cfg_line_control);
+    mem.cfg_baud_divisor(cfg_baud_divisor);
+    mem.cfg_baud_fraction(cfg_baud_fraction);
+    mem.cfg_fifo_control(cfg_fifo_control);
+    mem.cfg_rx_control(cfg_rx_control);
+    mem.cfg_modem_control(cfg_modem_control);
+    mem.cfg_rts_threshold(cfg_rts_threshold);
+    mem.cfg_int_enable(cfg_int_enable);
+    mem.cfg_station(cfg_station);
+    mem.cfg_rs485_control(cfg_rs485_control);
+    mem.cfg_crc_control(cfg_crc_control);
+    mem.cfg_framing_control(cfg_framing_control);
+    mem.cfg_match_char(cfg_match_char);
 
     // === Trace file ===
     sc_trace_file* tf = sc_create_vcd_trace_file("memory_map_trace");
@@ -90,29 +138,65 @@ int sc_main(int argc, char* argv[]) {
     sc_trace(tf, error_indicator, "error_indicator");
 
     // === Clock & timing ===
-    const unsigned CYCLE_LENGTH = 10;  // ns
-    sc_time cycle_time(CYCLE_LENGTH, SC_NS);
-    sc_spawn(sc_bind(clock_gen, ref(clk), CYCLE_LENGTH));
+    const unsigned CYCLE = 10;  // ns
+    sc_time cycle_time(CYCLE, SC_NS);
+    sc_spawn(sc_bind(clock_gen, ref(clk), CYCLE));
 
     // === Initialization & reset ===
     cout << "=== INITIAL RESET SEQUENCE ===" << endl;
-    rst.write(true);
+    rst.write(false);
     chip_select.write(false);
     read_write.write(false);
     write_enable.write(false);
+    byte_enable.write(1);
+    burst.write(false);
     data_in.write(0);
     addr.write(0);
     dp_data_in.write(0);
     dp_addr.write(0);
+    tx_fetch_addr.write(0);
     dp_write_enable.write(false);
     tx_buffer_full.write(false);
     rx_buffer_empty.write(true);
     error_indicator.write(false);
+    int_id.write(1);  // No interrupt pending
+    rx_timeout.write(false);
+    tx_crc.write(0);
+    rx_crc.write(0);
+    match_pending.write(false);
+    match_index.write(0);
+    dp_ts_data.write(0);
+    ts_tx_event.write(false);
+    tx_idle.write(true);
+    tx_tail.write(0);
+    rx_head.write(0);
 
     sc_start(cycle_time);
-    rst.write(false);
+    rst.write(true);
     sc_time t = SC_ZERO_TIME;
 
+    // Reset the memory map and park every input the tests drive, so a
+    // test that starts with it does not depend on the ones before it
+    auto reset_dut = [&]() {
+        chip_select.write(false);
+        read_write.write(false);
+        write_enable.write(false);
+        burst.write(false);
+        dp_write_enable.write(false);
+        tx_fetch_addr.write(0);
+        error_indicator.write(false);
+        match_pending.write(false);
+        match_index.write(0);
+        dp_ts_data.write(0);
+        ts_tx_event.write(false);
+        tx_idle.write(true);
+        tx_tail.write(0);
+        rx_head.write(0);
+        rst.write(false);
+        run_instruction(t, cycle_time, "Reset", 1);
+        rst.write(true);
+    };
+
     // TEST 1: LINE_CONTROL_REG write/read
     cout << "\n--- TEST 1: LINE_CONTROL_REG WRITE/READ ---" << endl;
     chip_select.write(true);
@@ -167,17 +251,33 @@ int sc_main(int argc, char* argv[]) {
     addr.write(LINE_STATUS_REG);
     read_write.write(false);
 
-    // 4a: no error (only DATA_READY)
+    // 4a: no error (only DATA_READY). A datapath tail off the head
+    // leaves a byte in the TX ring, so neither THRE nor TEMT is set.
     tx_buffer_full.write(true);
+    tx_tail.write(1);
+    tx_idle.write(false);
     rx_buffer_empty.write(false);
     error_indicator.write(false);
-    run_instruction(t, cycle_time, "Read LSR with no errors", 1);
+    run_instruction(t, cycle_time, "Read LSR with no errors", 2);
     assert(data_out.read() == LSR_DATA_READY);
     cout << "Result: LSR == DATA_READY only" << endl;
 
+    // THRE follows the ring, TEMT also waits for the transmitter
+    tx_buffer_full.write(false);
+    tx_tail.write(0);
+    run_instruction(t, cycle_time, "Read LSR with ring empty, frame on the line", 2);
+    assert(data_out.read() == (LSR_DATA_READY | LSR_TX_EMPTY));
+    cout << "Result: LSR == DATA_READY | TX_EMPTY" << endl;
+
+    tx_idle.write(true);
+    run_instruction(t, cycle_time, "Read LSR with transmitter idle", 2);
+    assert(data_out.read() == (LSR_DATA_READY | LSR_TX_EMPTY | LSR_TX_IDLE));
+    cout << "Result: LSR == DATA_READY | TX_EMPTY | TX_IDLE" << endl;
+    tx_buffer_full.write(true);
+
     // 4b: with error (PARITY+FRAMING)
     error_indicator.write(true);
-    run_instruction(t, cycle_time, "Read LSR with error_indicator=true", 1);
+    run_instruction(t, cycle_time, "Read LSR with error_indicator=true", 2);
     assert((data_out.read() & (LSR_PARITY_ERROR|LSR_FRAMING_ERROR)) != 0);
     cout << "Result: LSR includes PARITY and FRAMING errors" << endl;
     chip_select.write(false);
@@ -246,19 +346,463 @@ int sc_main(int argc, char* argv[]) {
 
     tx_buffer_full.write(false);
     rx_buffer_empty.write(true);
-    run_instruction(t, cycle_time, "Read FSR with TX not full, RX empty", 1);
+    run_instruction(t, cycle_time, "Read FSR with TX not full, RX empty", 2);
     assert(data_out.read() == FSR_RX_EMPTY);
     cout << "Result: FSR == RX_EMPTY only" << endl;
 
     tx_buffer_full.write(true);
     rx_buffer_empty.write(false);
-    run_instruction(t, cycle_time, "Read FSR with TX full, RX not empty", 1);
+    run_instruction(t, cycle_time, "Read FSR with TX full, RX not empty", 2);
     assert(data_out.read() == FSR_TX_FULL);
     cout << "Result: FSR == TX_FULL only" << endl;
     chip_select.write(false);
 
+    // TEST 8: DATA PORT PUSH/POP
+    cout << "\n--- TEST 8: DATA PORT PUSH / POP ---" << endl;
+    addr.write(DATA_PORT_REG);
+    read_write.write(true);
+    data_in.write(0x31);
+    chip_select.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Push 0x31 through the data port", 2);
+    write_enable.write(false);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+    assert(tx_head.read() == 1);
+    assert(mem.get_tx_buffer(0) == 0x31);
+    cout << "Result: one push per access, TX head == 1" << endl;
+
+    dp_data_in.write(0x4E);
+    dp_addr.write(RX_BUFFER_START);
+    dp_write_enable.write(true);
+    run_instruction(t, cycle_time, "Datapath writes 0x4E to RX buffer[0]", 1);
+    dp_write_enable.write(false);
+    rx_head.write(1);
+
+    read_write.write(false);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop through the data port", 2);
+    assert(data_out.read() == 0x4E);
+    assert(rx_tail.read() == 1);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop from an empty ring", 1);
+    assert(data_out.read() == 0);
+    assert(rx_tail.read() == 1);
+    cout << "Result: RX pop returns 0x4E, empty pop leaves the tail" << endl;
+    chip_select.write(false);
+
+    // TEST 9: BURST WRITES
+    cout << "\n--- TEST 9: AUTO-INCREMENT BURST ---" << endl;
+    addr.write(SCRATCH_REG1);
+    read_write.write(true);
+    write_enable.write(true);
+    burst.write(true);
+    chip_select.write(true);
+    data_in.write(0x12);
+    run_instruction(t, cycle_time, "Burst beat 0 -> SCRATCH_REG1", 1);
+    data_in.write(0x34);
+    run_instruction(t, cycle_time, "Burst beat 1 -> SCRATCH_REG2", 1);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "End burst", 1);
+
+    addr.write(DATA_PORT_REG);
+    chip_select.write(true);
+    data_in.write(0x61);
+    run_instruction(t, cycle_time, "Data port burst beat 0", 1);
+    data_in.write(0x62);
+    run_instruction(t, cycle_time, "Data port burst beat 1", 1);
+    chip_select.write(false);
+    write_enable.write(false);
+    burst.write(false);
+    run_instruction(t, cycle_time, "End burst", 1);
+    assert(tx_head.read() == 3);
+    assert(mem.get_tx_buffer(1) == 0x61 && mem.get_tx_buffer(2) == 0x62);
+
+    read_write.write(false);
+    chip_select.write(true);
+    addr.write(SCRATCH_REG1);
+    run_instruction(t, cycle_time, "Read back SCRATCH_REG1", 1);
+    assert(data_out.read() == 0x12);
+    addr.write(SCRATCH_REG2);
+    run_instruction(t, cycle_time, "Read back SCRATCH_REG2", 1);
+    assert(data_out.read() == 0x34);
+    cout << "Result: register burst increments, data port burst pushes per beat" << endl;
+    chip_select.write(false);
+
+    // TEST 10: CONFIGURATION SHADOWS
+    cout << "\n--- TEST 10: CONFIGURATION SHADOW PORTS ---" << endl;
+    reset_dut();
+    chip_select.write(true);
+    addr.write(LINE_CONTROL_REG);
+    data_in.write(0x5A);
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Write 0x5A to LINE_CONTROL_REG", 1);
+    addr.write(FIFO_CONTROL_REG);
+    data_in.write(0xAA);
+    run_instruction(t, cycle_time, "Write 0xAA to FIFO_CONTROL_REG", 1);
+    write_enable.write(false);
+    chip_select.write(false);
+    assert(cfg_line_control.read() == 0x5A);
+    assert(cfg_fifo_control.read() == 0xAA);
+    chip_select.write(true);
+    addr.write(BAUD_RATE_HIGH);
+    data_in.write(0x01);
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Write 0x01 to BAUD_RATE_HIGH", 1);
+    write_enable.write(false);
+    chip_select.write(false);
+    assert(cfg_baud_divisor.read() == 0x0103);
+    assert(cfg_station.read() == 0xFF00);
+    chip_select.write(true);
+    addr.write(STATION_ADDR_REG);
+    data_in.write(0x42);
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Write 0x42 to STATION_ADDR_REG", 1);
+    write_enable.write(false);
+    chip_select.write(false);
+    assert(cfg_station.read() == 0xFF42);
+    cout << "Result: shadows follow LCR, FCR, baud and station writes" << endl;
+
+    // TEST 11: CONCURRENT BANK ACCESS
+    cout << "\n--- TEST 11: HOST WRITE + TX FETCH + RX STORE IN ONE CYCLE ---" << endl;
+    reset_dut();
+    chip_select.write(true);
+    addr.write(TX_BUFFER_START + 1);
+    data_in.write(0x61);
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Queue 0x61 in TX slot 1", 1);
+    write_enable.write(false);
+    chip_select.write(false);
+
+    chip_select.write(true);
+    addr.write(TX_BUFFER_START + 7);
+    data_in.write(0x77);
+    read_write.write(true);
+    write_enable.write(true);
+    tx_fetch_addr.write(TX_BUFFER_START + 1);
+    dp_addr.write(RX_BUFFER_START + 7);
+    dp_data_in.write(0x88);
+    dp_write_enable.write(true);
+    run_instruction(t, cycle_time, "All three ports active", 1);
+    write_enable.write(false);
+    dp_write_enable.write(false);
+    chip_select.write(false);
+    assert(dp_data_out.read() == 0x61);
+    assert(mem.get_tx_buffer(7) == 0x77);
+    assert(mem.get_rx_buffer(7) == 0x88);
+    cout << "Result: no port waited on another" << endl;
+
+    // TEST 12: PER-CHARACTER ERROR TAGS
+    cout << "\n--- TEST 12: TAGGED RX BYTE ---" << endl;
+    reset_dut();
+    dp_addr.write(RX_BUFFER_START + 0);
+    dp_data_in.write((1 << RX_TAG_PARITY) | 0xA5);
+    dp_write_enable.write(true);
+    run_instruction(t, cycle_time, "Datapath stores 0xA5 with a parity tag", 1);
+    dp_write_enable.write(false);
+    rx_head.write(1);
+
+    chip_select.write(true);
+    addr.write(LINE_STATUS_REG);
+    read_write.write(false);
+    run_instruction(t, cycle_time, "Read LSR", 2);
+    assert((data_out.read() & LSR_PARITY_ERROR) != 0);
+    assert((data_out.read() & LSR_FRAMING_ERROR) == 0);
+    assert((data_out.read() & LSR_RX_FIFO_ERROR) != 0);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+
+    addr.write(DATA_PORT_REG);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop the tagged byte", 1);
+    assert(data_out.read() == (0x100 | 0xA5));
+    chip_select.write(false);
+
+    addr.write(LINE_STATUS_REG);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Read LSR after the pop", 2);
+    assert((data_out.read() & (LSR_PARITY_ERROR | LSR_RX_FIFO_ERROR)) == 0);
+    cout << "Result: tag reported in LSR and RBR bit 8, cleared by the pop" << endl;
+    chip_select.write(false);
+
+    // TEST 13: CRC CONTROL AND READBACK
+    cout << "\n--- TEST 13: CRC CONTROL / CRC DATA ---" << endl;
+    reset_dut();
+    tx_crc.write(0x12345678);
+    rx_crc.write(0x9ABCDEF0);
+    chip_select.write(true);
+    addr.write(CRC_CONTROL_REG);
+    data_in.write(CRC_MODE_32 | 0x04 | 0x20);  // CRC-32, clear TX, byte 1
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Select CRC-32, clear TX CRC, read byte 1", 1);
+    write_enable.write(false);
+    assert(cfg_crc_control.read() == (CRC_MODE_32 | 0x04));
+    read_write.write(false);
+    run_instruction(t, cycle_time, "Read CRC_CONTROL_REG", 1);
+    assert(data_out.read() == (CRC_MODE_32 | 0x20));
+    addr.write(CRC_DATA_REG);
+    run_instruction(t, cycle_time, "Read TX CRC byte 1", 2);
+    assert(data_out.read() == 0x56);
+    chip_select.write(false);
+
+    chip_select.write(true);
+    addr.write(CRC_CONTROL_REG);
+    data_in.write(CRC_MODE_32 | 0x04 | 0x10 | 0x60);  // clear TX again, RX byte 3
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Clear TX CRC again, read RX byte 3", 1);
+    write_enable.write(false);
+    assert(cfg_crc_control.read() == CRC_MODE_32);
+    addr.write(CRC_DATA_REG);
+    read_write.write(false);
+    run_instruction(t, cycle_time, "Read RX CRC byte 3", 2);
+    assert(data_out.read() == 0x9A);
+    cout << "Result: clear bits toggle the shadow, CRC_DATA follows the select" << endl;
+    chip_select.write(false);
+
+    // TEST 14: SLIP FRAME END
+    cout << "\n--- TEST 14: FRAMING CONTROL / FRAME-END TAG ---" << endl;
+    reset_dut();
+    chip_select.write(true);
+    addr.write(FRAMING_CONTROL_REG);
+    data_in.write(FRAMING_SLIP | (FRAMING_SLIP << 2));
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "SLIP framing both ways", 1);
+    write_enable.write(false);
+    read_write.write(false);
+    chip_select.write(false);
+    assert(cfg_framing_control.read() == (FRAMING_SLIP | (FRAMING_SLIP << 2)));
+
+    dp_addr.write(RX_BUFFER_START + 0);
+    dp_data_in.write((1 << RX_TAG_FRAME_END) | 0x5A);
+    dp_write_enable.write(true);
+    run_instruction(t, cycle_time, "Datapath stores the last byte of a packet", 1);
+    dp_write_enable.write(false);
+    rx_head.write(1);
+
+    chip_select.write(true);
+    addr.write(LINE_STATUS_REG);
+    run_instruction(t, cycle_time, "Read LSR", 2);
+    assert((data_out.read() & 0x100) != 0);                 // LSR frame end
+    assert((data_out.read() & LSR_RX_FIFO_ERROR) == 0);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+
+    addr.write(DATA_PORT_REG);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop the frame-end byte", 1);
+    assert(data_out.read() == 0x5A);
+    cout << "Result: frame end reported in LSR, not counted as an error" << endl;
+    chip_select.write(false);
+
+    // TEST 15: CHARACTER MATCH
+    cout << "\n--- TEST 15: MATCH CHAR / MATCH INDEX ---" << endl;
+    reset_dut();
+    chip_select.write(true);
+    addr.write(MATCH_CHAR_REG);
+    data_in.write(0x100 | '\n');  // Enable, match newline
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Match on newline", 1);
+    write_enable.write(false);
+    read_write.write(false);
+    chip_select.write(false);
+    assert(cfg_match_char.read() == (0x100 | '\n'));
+
+    // Datapath stored "A\n" in slots 0 and 1 and latched slot 1
+    mem.set_rx_buffer(0, 'A');
+    mem.set_rx_buffer(1, '\n');
+    rx_head.write(2);
+    match_index.write(1);
+    match_pending.write(true);
+
+    chip_select.write(true);
+    addr.write(MATCH_INDEX_REG);
+    run_instruction(t, cycle_time, "Read MATCH_INDEX", 2);
+    assert(data_out.read() == 2);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+
+    addr.write(DATA_PORT_REG);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop 'A'", 1);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop the newline", 1);
+    assert(data_out.read() == '\n');
+    chip_select.write(false);
+
+    chip_select.write(true);
+    addr.write(MATCH_INDEX_REG);
+    run_instruction(t, cycle_time, "Read MATCH_INDEX after the pops", 2);
+    assert(data_out.read() == 0);
+    cout << "Result: bytes through the match reported, cleared once popped" << endl;
+    chip_select.write(false);
+
+    // TEST 16: FRAME TIMESTAMPS
+    cout << "\n--- TEST 16: TIMESTAMP FIFOS ---" << endl;
+    reset_dut();
+    ts_tx_event.write(true);
+    run_instruction(t, cycle_time, "TX stop bit ends", 1);
+    ts_tx_event.write(false);
+    run_instruction(t, cycle_time, "Next TX stop bit ends", 1);
+
+    chip_select.write(true);
+    addr.write(TS_CONTROL_REG);
+    data_in.write(0x01);  // TX FIFO, byte 0
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Select the TX FIFO", 1);
+    write_enable.write(false);
+    read_write.write(false);
+    run_instruction(t, cycle_time, "Read TS_CONTROL", 2);
+    assert((data_out.read() & 0x10) != 0);  // TS_READY
+    addr.write(TS_DATA_REG);
+    run_instruction(t, cycle_time, "Read the first stamp, byte 0", 2);
+    sc_uint<8> first = data_out.read();
+    chip_select.write(false);
+
+    chip_select.write(true);
+    addr.write(TS_CONTROL_REG);
+    data_in.write(0x01 | 0x08);  // Pop the TX FIFO
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Pop the first TX stamp", 1);
+    write_enable.write(false);
+    addr.write(TS_DATA_REG);
+    read_write.write(false);
+    run_instruction(t, cycle_time, "Read the second stamp, byte 0", 2);
+    sc_uint<8> second = data_out.read();
+    assert(second != first);
+    chip_select.write(false);
+
+    // An RX stamp comes in with its byte, sits beside it in the ring
+    // and leaves with it on the RBR read
+    sc_uint<32> count = ts_count.read();
+    run_instruction(t, cycle_time, "Counter runs", 1);
+    assert(ts_count.read() != count);
+
+    chip_select.write(true);
+    addr.write(TS_CONTROL_REG);
+    data_in.write(0x00);  // RX FIFO, byte 0
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Select the RX FIFO", 1);
+    write_enable.write(false);
+    read_write.write(false);
+    run_instruction(t, cycle_time, "Read TS_CONTROL before the store", 2);
+    assert((data_out.read() & 0x10) == 0);
+    chip_select.write(false);
+
+    dp_addr.write(RX_BUFFER_START + 0);
+    dp_data_in.write('B');
+    dp_ts_data.write(0x12345678);
+    dp_write_enable.write(true);
+    run_instruction(t, cycle_time, "Datapath stores the byte and its stamp", 1);
+    dp_write_enable.write(false);
+    rx_head.write(1);
+
+    chip_select.write(true);
+    addr.write(TS_DATA_REG);
+    run_instruction(t, cycle_time, "Read the RX stamp, byte 0", 2);
+    assert(data_out.read() == 0x78);
+    addr.write(TS_CONTROL_REG);
+    data_in.write(0x06);  // RX FIFO, byte 3
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Select byte 3", 1);
+    write_enable.write(false);
+    read_write.write(false);
+    addr.write(TS_DATA_REG);
+    run_instruction(t, cycle_time, "Read the RX stamp, byte 3", 2);
+    assert(data_out.read() == 0x12);
+    chip_select.write(false);
+
+    addr.write(DATA_PORT_REG);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop the byte through RBR", 1);
+    assert(data_out.read() == 'B');
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+
+    chip_select.write(true);
+    addr.write(TS_CONTROL_REG);
+    run_instruction(t, cycle_time, "Read TS_CONTROL after the pop", 2);
+    assert((data_out.read() & 0x10) == 0);
+    cout << "Result: TX stamps in order, RX stamp follows its byte" << endl;
+    chip_select.write(false);
+
+    // TEST 17: HOST OVERWRITE OF A TAGGED RX ENTRY
+    cout << "\n--- TEST 17: RX ERROR COUNT ON OVERWRITE ---" << endl;
+    reset_dut();
+
+    dp_addr.write(RX_BUFFER_START + 0);
+    dp_data_in.write((1 << RX_TAG_FRAMING) | 0x11);
+    dp_write_enable.write(true);
+    run_instruction(t, cycle_time, "Datapath stores a tagged byte", 1);
+    dp_write_enable.write(false);
+    rx_head.write(1);
+
+    chip_select.write(true);
+    addr.write(RX_BUFFER_START + 0);
+    data_in.write(0x22);
+    read_write.write(true);
+    write_enable.write(true);
+    run_instruction(t, cycle_time, "Host overwrites the tagged entry", 1);
+    write_enable.write(false);
+    read_write.write(false);
+    addr.write(LINE_STATUS_REG);
+    run_instruction(t, cycle_time, "Read LSR", 2);
+    assert((data_out.read() & (LSR_FRAMING_ERROR | LSR_RX_FIFO_ERROR)) == 0);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+
+    addr.write(DATA_PORT_REG);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop the overwritten byte", 1);
+    assert(data_out.read() == 0x22);
+    chip_select.write(false);
+
+    // The count did not go negative: a new tagged byte sets the flag
+    // and its pop clears it
+    dp_addr.write(RX_BUFFER_START + 1);
+    dp_data_in.write((1 << RX_TAG_PARITY) | 0x33);
+    dp_write_enable.write(true);
+    run_instruction(t, cycle_time, "Datapath stores another tagged byte", 1);
+    dp_write_enable.write(false);
+    rx_head.write(2);
+
+    chip_select.write(true);
+    addr.write(LINE_STATUS_REG);
+    run_instruction(t, cycle_time, "Read LSR", 2);
+    assert((data_out.read() & LSR_RX_FIFO_ERROR) != 0);
+    chip_select.write(false);
+    run_instruction(t, cycle_time, "Release chip select", 1);
+
+    addr.write(DATA_PORT_REG);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Pop the tagged byte", 1);
+    chip_select.write(false);
+
+    addr.write(LINE_STATUS_REG);
+    chip_select.write(true);
+    run_instruction(t, cycle_time, "Read LSR after the pop", 2);
+    assert((data_out.read() & LSR_RX_FIFO_ERROR) == 0);
+    cout << "Result: overwriting a tagged entry takes it out of the count" << endl;
+    chip_select.write(false);
+
     // === Finish ===
-    cout << "\nAll memory_map tests 1-7 passed successfully." << endl;
+    cout << "\nAll memory_map tests 1-17 passed successfully." << endl;
     sc_close_vcd_trace_file(tf);
     return 0;
 }
\ No newline at end of file
@@ -4,12 +4,16 @@
  * Date: 4/22/2025
  *
  * This file contains the sc_main function for
- * testing the UART top-level module
+ * testing the UART top-level module. The tests
+ * only use the top ports, build it with both
+ * -DUART_FUSED_CORE=0 and -DUART_FUSED_CORE=1
+ * so the two cores are held to the same results.
  *********************************************/
 
 #include "systemc.h"
 #include "../src/top.h"
 #include "../src/sizes.h"
+#include <cassert>
 
 // Clock generation function
 void clock_gen(sc_signal<bool>& clk, int period) {
@@ -23,12 +27,16 @@ void clock_gen(sc_signal<bool>& clk, int period) {
 
 // Test top module
 int sc_main(int argc, char* argv[]) {
-    // Create signals
-    sc_signal<bool> clk, rst;
-    sc_signal<sc_uint<DATA_W>> data_in, data_out;
+    // Create the clock and signals
+    sc_clock clk("clk", CYCLE_LENGTH, SC_NS);
+    sc_signal<bool> rst;
+    sc_signal<sc_uint<HOST_DATA_W>> data_in, data_out;
+    sc_signal<sc_uint<HOST_LANES>> byte_enable, byte_valid;
+    sc_signal<bool> burst;
     sc_signal<sc_uint<ADDR_W>> addr;
     sc_signal<bool> chip_select, read_write, write_enable;
     sc_signal<bool> rx_in, tx_out;
+    sc_signal<bool> cts, rts, de, irq;
     sc_signal<bool> tx_buffer_full, rx_buffer_empty, error_indicator;
     
     // Instantiate top module
@@ -41,16 +49,19 @@ int sc_main(int argc, char* argv[]) {
     uart_top.chip_select(chip_select);
     uart_top.read_write(read_write);
     uart_top.write_enable(write_enable);
+    uart_top.byte_enable(byte_enable);
+    uart_top.burst(burst);
+    uart_top.byte_valid(byte_valid);
     uart_top.rx_in(rx_in);
     uart_top.tx_out(tx_out);
+    uart_top.cts(cts);
+    uart_top.rts(rts);
+    uart_top.de(de);
+    uart_top.irq(irq);
     uart_top.tx_buffer_full(tx_buffer_full);
     uart_top.rx_buffer_empty(rx_buffer_empty);
     uart_top.error_indicator(error_indicator);
     
-    // Create a process for clock generation
-    sc_clock system_clk("system_clk", CYCLE_LENGTH, SC_NS);
-    clk(system_clk);
-    
     // Create trace file
     sc_trace_file *tf = sc_create_vcd_trace_file("uart_top_trace");
     sc_trace(tf, clk, "clk");
@@ -63,22 +74,113 @@ int sc_main(int argc, char* argv[]) {
     sc_trace(tf, write_enable, "write_enable");
     sc_trace(tf, rx_in, "rx_in");
     sc_trace(tf, tx_out, "tx_out");
+    sc_trace(tf, cts, "cts");
+    sc_trace(tf, rts, "rts");
+    sc_trace(tf, de, "de");
+    sc_trace(tf, irq, "irq");
     sc_trace(tf, tx_buffer_full, "tx_buffer_full");
     sc_trace(tf, rx_buffer_empty, "rx_buffer_empty");
     sc_trace(tf, error_indicator, "error_indicator");
     
+    // One protocol loop iteration of every module, and a bit period at
+    // the fastest line rate (divisor 1, 4x oversampling)
+    const int ITER_NS = UART_SINGLE_CYCLE ? CYCLE_LENGTH : 2 * CYCLE_LENGTH;
+    const int BIT_NS = 4 * ITER_NS;
+    
+    // Single host register access. Chip select drops afterwards, so a
+    // data port access pushes or pops exactly once.
+    auto reg_write = [&](unsigned int address, unsigned int value) {
+        chip_select.write(true);
+        read_write.write(true);
+        write_enable.write(true);
+        addr.write(address);
+        data_in.write(value);
+        sc_start(ITER_NS, SC_NS);
+        chip_select.write(false);
+        write_enable.write(false);
+        sc_start(ITER_NS, SC_NS);
+    };
+    
+    auto reg_read = [&](unsigned int address) -> unsigned int {
+        chip_select.write(true);
+        read_write.write(false);
+        addr.write(address);
+        sc_start(2 * ITER_NS, SC_NS);
+        unsigned int value = data_out.read();
+        chip_select.write(false);
+        sc_start(ITER_NS, SC_NS);
+        return value;
+    };
+    
+    // Reset (active low), then program the fastest line rate so each
+    // end-to-end test starts from the same state whatever ran before it
+    auto reset_fast = [&]() {
+        chip_select.write(false);
+        write_enable.write(false);
+        burst.write(false);
+        rx_in.write(1);
+        cts.write(true);
+        rst.write(false);
+        sc_start(4 * ITER_NS, SC_NS);
+        rst.write(true);
+        sc_start(2 * ITER_NS, SC_NS);
+        reg_write(BAUD_RATE_LOW, 0x01);
+        reg_write(RX_CONTROL_REG, 0x02);  // 4x oversampling
+    };
+    
+    // Wait up to timeout bit periods for a start bit on tx_out, then
+    // sample the frame at mid-bit. Returns the data bits, or -1 on a
+    // timeout or a stop bit that is not mark.
+    auto capture_frame = [&](int data_bits, int stop_bits, int timeout) -> int {
+        for (int i = 0; tx_out.read(); i++) {
+            if (i >= timeout * 4) {
+                return -1;
+            }
+            sc_start(ITER_NS, SC_NS);
+        }
+        sc_start(BIT_NS / 2, SC_NS);
+        
+        int value = 0;
+        for (int i = 0; i < data_bits; i++) {
+            sc_start(BIT_NS, SC_NS);
+            value |= tx_out.read() << i;
+        }
+        for (int i = 0; i < stop_bits; i++) {
+            sc_start(BIT_NS, SC_NS);
+            if (!tx_out.read()) {
+                return -1;
+            }
+        }
+        return value;
+    };
+    
+    // Drive one frame into rx_in, LSB first
+    auto send_frame = [&](int value, int data_bits, int stop_bits) {
+        rx_in.write(0);
+        sc_start(BIT_NS, SC_NS);
+        for (int i = 0; i < data_bits; i++) {
+            rx_in.write((value >> i) & 1);
+            sc_start(BIT_NS, SC_NS);
+        }
+        rx_in.write(1);
+        sc_start(stop_bits * BIT_NS, SC_NS);
+    };
+    
     // Initialize signals
-    rst.write(true);
+    rst.write(false);
     data_in.write(0);
     addr.write(0);
     chip_select.write(false);
     read_write.write(false);
     write_enable.write(false);
+    byte_enable.write(1);
+    burst.write(false);
     rx_in.write(1);  // Idle state is high
+    cts.write(true); // Far end ready to receive
     
     // Run simulation
     sc_start(20, SC_NS);  // Run with reset active
-    rst.write(false);     // Release reset
+    rst.write(true);      // Release reset
     sc_start(20, SC_NS);
     
     // Test 1: Configure UART
@@ -138,6 +240,305 @@ int sc_main(int argc, char* argv[]) {
     addr.write(8);  // RX buffer address
     sc_start(10, SC_NS);
     
+    // Test 7: Internal loopback - the byte sent comes back through the
+    // receiver without touching rx_in
+    read_write.write(true);
+    write_enable.write(true);
+    addr.write(MODEM_CONTROL_REG);
+    data_in.write(0x12);  // RTS + loopback
+    sc_start(10, SC_NS);
+    
+    addr.write(DATA_PORT_REG);
+    data_in.write(0xA5);
+    sc_start(10, SC_NS);
+    chip_select.write(false);
+    write_enable.write(false);
+    sc_start(10000, SC_NS);  // One frame at the default divisor
+    
+    chip_select.write(true);
+    read_write.write(false);
+    addr.write(DATA_PORT_REG);  // Pop the looped-back byte
+    sc_start(10, SC_NS);
+    cout << "Loopback received 0x" << hex << data_out.read() << dec << endl;
+    
+    // Test 8: RS-485 turnaround - DE is up while the frame is on the
+    // line and back down once the stop bit and guard time are over
+    read_write.write(true);
+    write_enable.write(true);
+    addr.write(MODEM_CONTROL_REG);
+    data_in.write(0x02);  // RTS, loopback off
+    sc_start(10, SC_NS);
+    
+    addr.write(RS485_CONTROL_REG);
+    data_in.write(0x11);  // DE enable, one bit period guard
+    sc_start(10, SC_NS);
+    
+    addr.write(DATA_PORT_REG);
+    data_in.write(0x5A);
+    sc_start(10, SC_NS);
+    chip_select.write(false);
+    write_enable.write(false);
+    sc_start(2000, SC_NS);
+    cout << "DE during frame: " << de.read() << endl;
+    sc_start(12000, SC_NS);  // Frame plus guard time
+    cout << "DE after guard: " << de.read() << endl;
+    
+    // Test 9: Idle RS-485 node - with DE enabled and nothing queued the
+    // driver stays off and the line stays at mark
+    reset_fast();
+    reg_write(RS485_CONTROL_REG, 0x11);  // DE enable, one bit period guard
+    for (int i = 0; i < 64; i++) {
+        sc_start(BIT_NS, SC_NS);
+        assert(!de.read() && "DE raised with an empty TX ring");
+        assert(tx_out.read() && "Idle line left mark");
+    }
+    
+    // Test 10: DE brackets a real frame - up ahead of the start bit,
+    // down again once the stop bit and the guard time are over
+    reg_write(DATA_PORT_REG, 0x5A);
+    for (int i = 0; !de.read() && i < 64; i++) {
+        sc_start(ITER_NS, SC_NS);
+    }
+    assert(de.read() && "DE never raised for a queued byte");
+    assert(tx_out.read() && "DE must lead the start bit");
+    assert(capture_frame(8, 1, 4) == 0x5A);
+    assert(de.read() && "DE dropped inside the guard time");
+    sc_start(4 * BIT_NS, SC_NS);
+    assert(!de.read() && "DE held after the guard time");
+    cout << "RS-485 idle and frame DE checks passed" << endl;
+    
+    // Test 11: Host writes alongside a TX fetch and an RX store - with
+    // loopback on, two queued bytes go out and come back while the host
+    // writes a scratch register on every cycle
+    reset_fast();
+    reg_write(MODEM_CONTROL_REG, 0x12);  // RTS + loopback
+    reg_write(DATA_PORT_REG, 0x3C);
+    reg_write(DATA_PORT_REG, 0xC3);
+    chip_select.write(true);
+    read_write.write(true);
+    write_enable.write(true);
+    addr.write(SCRATCH_REG1);
+    for (int i = 0; i < 3 * 10 * 4; i++) {  // Three frame times
+        data_in.write(i & 0xFF);
+        sc_start(ITER_NS, SC_NS);
+    }
+    chip_select.write(false);
+    write_enable.write(false);
+    sc_start(4 * BIT_NS, SC_NS);
+    assert(reg_read(DATA_PORT_REG) == 0x3C && "First looped-back byte");
+    assert(reg_read(DATA_PORT_REG) == 0xC3 && "Second looped-back byte");
+    assert(reg_read(SCRATCH_REG1) == ((3 * 10 * 4 - 1) & 0xFF) && "Host writes all landed");
+    cout << "Concurrent host write, TX fetch and RX store passed" << endl;
+    
+    // Test 12: Host burst during receive - back-to-back bursts over the
+    // TX bank run for the whole frame, and the oversampler and baud
+    // counters keep going so the byte still arrives intact
+    reset_fast();
+    read_write.write(true);
+    write_enable.write(true);
+    burst.write(true);
+    for (int i = 0; i < (1 + 8 + 1) * 4 + 8; i++) {
+        int bit = i / 4;  // Four iterations per bit at 4x oversampling
+        rx_in.write(bit == 0 ? 0 : (bit <= 8 ? (0x96 >> (bit - 1)) & 1 : 1));
+        
+        // TX_BUFFER_SIZE beats from the bank start, one idle cycle, again
+        chip_select.write(i % (TX_BUFFER_SIZE + 1) != TX_BUFFER_SIZE);
+        addr.write(TX_BUFFER_START);
+        data_in.write(i & 0xFF);
+        sc_start(ITER_NS, SC_NS);
+    }
+    chip_select.write(false);
+    write_enable.write(false);
+    burst.write(false);
+    rx_in.write(1);
+    sc_start(4 * BIT_NS, SC_NS);
+    assert(reg_read(DATA_PORT_REG) == 0x96 && "Byte received during the burst, no error flag");
+    cout << "Burst during receive passed" << endl;
+    
+    // Test 13: 8N2 back to back - both stop bits are mark and the next
+    // start bit follows straight after the second one. THRE waits for
+    // the ring to drain and TEMT for the last stop bit as well.
+    reset_fast();
+    reg_write(LINE_CONTROL_REG, 0x07);  // 8 data bits, 2 stop bits
+    reg_write(DATA_PORT_REG, 0xA5);
+    reg_write(DATA_PORT_REG, 0x3C);
+    assert(!(reg_read(LINE_STATUS_REG) & 0x60) && "THRE or TEMT with bytes in the ring");
+    assert(capture_frame(8, 2, 64) == 0xA5 && "First 8N2 frame");
+    assert(capture_frame(8, 2, 1) == 0x3C && "Second 8N2 frame, back to back");
+    assert((reg_read(LINE_STATUS_REG) & 0x60) == 0x20 && "TEMT before the last stop bit ended");
+    sc_start(BIT_NS, SC_NS);
+    assert((reg_read(LINE_STATUS_REG) & 0x60) == 0x60 && "No TEMT after the last frame");
+    cout << "8N2 back-to-back frames passed" << endl;
+    
+    // Test 14: Line status lasts until the next frame - a framing error
+    // holds the line status interrupt through idle time and the next
+    // good frame clears it
+    reset_fast();
+    reg_write(INT_ENABLE_REG, 0x04);  // Line status only
+    rx_in.write(0);
+    sc_start(BIT_NS, SC_NS);
+    for (int i = 0; i < 8; i++) {
+        rx_in.write((0x55 >> i) & 1);
+        sc_start(BIT_NS, SC_NS);
+    }
+    sc_start(BIT_NS, SC_NS);  // Stop bit left at space
+    rx_in.write(1);
+    for (int i = 0; i < 8; i++) {
+        sc_start(BIT_NS, SC_NS);
+        assert(irq.read() && "Line status dropped before the next frame");
+    }
+    send_frame(0x33, 8, 1);
+    sc_start(BIT_NS, SC_NS);
+    assert(!irq.read() && "Line status survived a good frame");
+    cout << "Line status lifetime passed" << endl;
+    
+    // Test 15: SLIP and timestamps - each RX stamp belongs to its own
+    // byte even though the de-framer holds a byte back, and TX stamps
+    // mark the end of the second stop bit
+    const unsigned int ITER_CYCLES = ITER_NS / CYCLE_LENGTH;
+    auto read_stamp = [&](unsigned int select) -> unsigned int {
+        unsigned int stamp = 0;
+        for (int b = 0; b < 4; b++) {
+            reg_write(TS_CONTROL_REG, select | (b << 1));
+            stamp |= reg_read(TS_DATA_REG) << (8 * b);
+        }
+        return stamp;
+    };
+    
+    reset_fast();
+    reg_write(FRAMING_CONTROL_REG, FRAMING_SLIP << 2);  // SLIP receive
+    send_frame('A', 8, 1);
+    sc_start(5 * BIT_NS, SC_NS);  // Idle gap before the next byte
+    send_frame('B', 8, 1);
+    send_frame(0xC0, 8, 1);       // END
+    sc_start(4 * BIT_NS, SC_NS);
+    assert((reg_read(TS_CONTROL_REG) & 0x10) && "No RX stamp with a byte in the ring");
+    unsigned int stamp_a = read_stamp(0x00);
+    assert(reg_read(DATA_PORT_REG) == 'A');
+    unsigned int stamp_b = read_stamp(0x00);
+    assert(reg_read(DATA_PORT_REG) == 'B');
+    assert(stamp_b - stamp_a == 15 * 4 * ITER_CYCLES && "RX stamps not on their own start bits");
+    assert(!(reg_read(TS_CONTROL_REG) & 0x10) && "RX stamp left after its byte was read");
+    
+    reg_write(LINE_CONTROL_REG, 0x07);  // 8N2
+    reg_write(DATA_PORT_REG, 0x11);
+    reg_write(DATA_PORT_REG, 0x22);
+    assert(capture_frame(8, 2, 64) == 0x11);
+    assert(capture_frame(8, 2, 1) == 0x22);
+    sc_start(2 * BIT_NS, SC_NS);
+    unsigned int stamp_1 = read_stamp(0x01);
+    reg_write(TS_CONTROL_REG, 0x01 | 0x08);  // Pop the TX FIFO
+    unsigned int stamp_2 = read_stamp(0x01);
+    assert(stamp_2 - stamp_1 == 11 * 4 * ITER_CYCLES && "TX stamps not one 8N2 frame apart");
+    cout << "SLIP receive and frame timestamps passed" << endl;
+    
+    // Test 16: Character match - a newline in the middle of the stream
+    // raises the match interrupt and MATCH_INDEX counts the bytes up to
+    // it; both clear once the newline has been read
+    reset_fast();
+    reg_write(MATCH_CHAR_REG, 0x100 | '\n');  // Enable, match newline
+    reg_write(INT_ENABLE_REG, 0x08);         // Character match only
+    send_frame('o', 8, 1);
+    send_frame('k', 8, 1);
+    send_frame('\n', 8, 1);
+    send_frame('x', 8, 1);
+    sc_start(4 * BIT_NS, SC_NS);
+    assert(irq.read() && "No interrupt for the match character");
+    assert((reg_read(INT_IDENT_REG) & 0x0F) == 0x0A && "IIR does not report the match");
+    assert(reg_read(MATCH_INDEX_REG) == 3 && "Match index counts through the newline");
+    assert(reg_read(DATA_PORT_REG) == 'o');
+    assert(reg_read(DATA_PORT_REG) == 'k');
+    assert(reg_read(MATCH_INDEX_REG) == 1);
+    assert(reg_read(DATA_PORT_REG) == '\n');
+    sc_start(2 * ITER_NS, SC_NS);
+    assert(reg_read(MATCH_INDEX_REG) == 0 && "Match index left after the pop");
+    assert(!irq.read() && "Match interrupt left after the pop");
+    cout << "Character match passed" << endl;
+    
+    // Test 17: Multidrop over the line - 9-bit frames go through the
+    // oversampler with no LCR parity, the address bit in the parity
+    // slot. Only data after our own address lands in the ring, and the
+    // real stop bit is never taken for the address bit.
+    reset_fast();
+    reg_write(STATION_ADDR_REG, 0x42);
+    reg_write(RX_CONTROL_REG, 0x12);  // 4x oversampling, multidrop
+    send_frame(0x100 | 0x17, 9, 1);   // Another station
+    send_frame('x', 9, 1);
+    send_frame(0x100 | 0x42, 9, 1);   // Us
+    send_frame('o', 9, 1);
+    send_frame('k', 9, 1);
+    send_frame(0x100 | 0x17, 9, 1);   // Deselected again
+    send_frame('y', 9, 1);
+    sc_start(4 * BIT_NS, SC_NS);
+    assert(!(reg_read(LINE_STATUS_REG) & 0x08) && "Framing error on a multidrop frame");
+    assert(reg_read(DATA_PORT_REG) == 'o' && "First byte for this station");
+    assert(reg_read(DATA_PORT_REG) == 'k' && "Second byte for this station");
+    assert(!(reg_read(LINE_STATUS_REG) & 0x01) && "Bytes for another station were stored");
+    cout << "Multidrop address filtering passed" << endl;
+    
+    // Test 18: 8N2 with both stop bits at space - the frame is a
+    // framing error and the second stop bit is not taken for the start
+    // of the next frame, so the good frame after it arrives intact
+    reset_fast();
+    reg_write(LINE_CONTROL_REG, 0x07);  // 8 data bits, 2 stop bits
+    rx_in.write(0);
+    sc_start(BIT_NS, SC_NS);
+    for (int i = 0; i < 8; i++) {
+        rx_in.write((0x55 >> i) & 1);
+        sc_start(BIT_NS, SC_NS);
+    }
+    rx_in.write(0);
+    sc_start(2 * BIT_NS, SC_NS);  // Both stop bits at space
+    rx_in.write(1);
+    sc_start(2 * BIT_NS, SC_NS);
+    send_frame(0xA3, 8, 2);
+    sc_start(4 * BIT_NS, SC_NS);
+    assert((reg_read(LINE_STATUS_REG) & 0x08) && "No framing error on the bad frame");
+    assert((reg_read(DATA_PORT_REG) & 0xFF) == 0x55 && "Bad frame's byte");
+    assert(!(reg_read(LINE_STATUS_REG) & 0x08) && "Framing error on the good frame");
+    assert(reg_read(DATA_PORT_REG) == 0xA3 && "Frame after a space second stop bit");
+    cout << "8N2 framing error resync passed" << endl;
+    
+    // Test 19: Autobaud on a start bit too long for a 16-bit divisor -
+    // the divisor saturates at 0xFFFF instead of wrapping to a fast rate
+    reset_fast();
+    reg_write(RX_CONTROL_REG, 0x06);  // 4x oversampling, start bit autobaud
+    rx_in.write(0);
+    sc_start(0x50000 * ITER_NS, SC_NS);  // Divisor 0x14000 at 4x
+    rx_in.write(1);
+    sc_start(16 * ITER_NS, SC_NS);
+    assert((reg_read(RX_CONTROL_REG) & 0x0C) == 0 && "Autobaud did not finish");
+    assert(reg_read(BAUD_RATE_LOW) == 0xFF && reg_read(BAUD_RATE_HIGH) == 0xFF &&
+           "Long start bit wrapped the divisor");
+    cout << "Autobaud divisor saturation passed" << endl;
+    
+    // Test 20: Receive with a divisor above 1 - the sampler keeps its
+    // frame across the iterations that have no sample tick
+    reset_fast();
+    reg_write(BAUD_RATE_LOW, 0x03);
+    for (int i = -1; i < 9; i++) {
+        rx_in.write(i < 0 ? 0 : i < 8 ? (0xC3 >> i) & 1 : 1);
+        sc_start(3 * BIT_NS, SC_NS);
+    }
+    sc_start(4 * BIT_NS, SC_NS);
+    assert(reg_read(DATA_PORT_REG) == 0xC3 && "Byte lost at divisor 3");
+    cout << "Receive at divisor 3 passed" << endl;
+
+#if UART_WIDE_BUS
+    // Test 21: Wide data port read - a parity error in lane 1 is
+    // flagged in RX_LANE_ERROR_REG, the good byte in lane 0 is not
+    reset_fast();
+    reg_write(LINE_CONTROL_REG, 0x1B);  // 8E1
+    send_frame(0x011, 9, 1);            // Parity bit 0, even
+    send_frame(0x122, 9, 1);            // Parity bit 1, odd
+    sc_start(4 * BIT_NS, SC_NS);
+    byte_enable.write(0x3);
+    assert(reg_read(DATA_PORT_REG) == 0x2211 && "Wide read lost a byte");
+    byte_enable.write(1);
+    assert(reg_read(RX_LANE_ERROR_REG) == 0x2 && "Parity error not flagged on lane 1");
+    cout << "Wide read lane errors passed" << endl;
+#endif
+
     // Finish simulation
     chip_select.write(false);
     sc_start(50, SC_NS);
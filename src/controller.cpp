@@ -10,10 +10,69 @@
 
 using namespace std;
 
-void controller::process() {
+// TX and RX run as separate threads. They share no state, only the
+// clock, so each direction is scheduled on its own and a long path in
+// one cannot stretch the other.
+void controller::process_tx() {
     {
         HLS_DEFINE_PROTOCOL("reset");
-        reset_control_clear_regs();
+        reset_tx_regs();
+        write_tx_outputs();
+    }
+    
+    {       
+        HLS_DEFINE_PROTOCOL("wait");
+        wait();
+    }
+
+    while(true) {
+        // Read inputs
+        {
+            HLS_DEFINE_PROTOCOL("input");
+            read_tx_inputs();
+        }
+        
+        // Check if memory write is active
+        if(!mem_we.read()) {
+            if(start.read()) {
+                {
+                    HLS_DEFINE_PROTOCOL("start");
+                    reset_tx_regs();
+                }
+            } else {
+                {
+                    HLS_DEFINE_PROTOCOL("tx_fsm");
+                    tx_fsm();
+                }
+                
+                {
+                    HLS_DEFINE_PROTOCOL("output");
+                    write_tx_outputs();
+                }
+            }
+        }
+        
+        // Wait for next cycle
+        {       
+            HLS_DEFINE_PROTOCOL("wait");
+            wait();
+        }
+
+#if !UART_SINGLE_CYCLE
+        // Additional wait for processing time
+        {       
+            HLS_DEFINE_PROTOCOL("wait");
+            wait();
+        }
+#endif
+    }
+}
+
+void controller::process_rx() {
+    {
+        HLS_DEFINE_PROTOCOL("reset");
+        reset_rx_regs();
+        write_rx_outputs();
     }
     
     {       
@@ -25,25 +84,25 @@ void controller::process() {
         // Read inputs
         {
             HLS_DEFINE_PROTOCOL("input");
-            read_inputs();
+            read_rx_inputs();
         }
         
         // Check if memory write is active
-        if(!in_mem_we) {
-            if(in_start) {
+        if(!mem_we.read()) {
+            if(start.read()) {
                 {
                     HLS_DEFINE_PROTOCOL("start");
-                    reset_control_clear_regs();
+                    reset_rx_regs();
                 }
             } else {
                 {
-                    HLS_DEFINE_PROTOCOL("controller_fsm");
-                    controller_fsm();
+                    HLS_DEFINE_PROTOCOL("rx_fsm");
+                    rx_fsm();
                 }
                 
                 {
                     HLS_DEFINE_PROTOCOL("output");
-                    write_outputs();
+                    write_rx_outputs();
                 }
             }
         }
@@ -54,67 +113,114 @@ void controller::process() {
             wait();
         }
 
+#if !UART_SINGLE_CYCLE
         // Additional wait for processing time
         {       
             HLS_DEFINE_PROTOCOL("wait");
             wait();
         }
+#endif
     }
 }
 
 void controller::reset_control_clear_regs() {
+    reset_tx_regs();
+    reset_rx_regs();
+}
+
+void controller::reset_tx_regs() {
     // Reset state registers
-    tx_state = TX_IDLE;
-    tx_next_state = TX_IDLE;
-    rx_state = RX_IDLE;
-    rx_next_state = RX_IDLE;
+    tx_state = CTRL_TX_IDLE;
+    tx_next_state = CTRL_TX_IDLE;
     
     // Reset counters and flags
     tx_bit_counter = 0;
-    rx_bit_counter = 0;
     tx_parity_value = false;
-    rx_parity_value = false;
     tx_done = false;
-    rx_done = false;
+    de_active = false;
+    de_guard_count = 0;
     
     // Clear all outputs
-    clear_output_sc_bits();
+    clear_tx_outputs();
+}
+
+void controller::reset_rx_regs() {
+    // Reset state registers
+    rx_state = CTRL_RX_IDLE;
+    rx_next_state = CTRL_RX_IDLE;
+    
+    // Reset counters and flags
+    rx_bit_counter = 0;
+    rx_parity_value = false;
+    
+    // Clear all outputs
+    clear_rx_outputs();
 }
 
 void controller::clear_output_sc_bits() {
-    // Clear all control outputs
+    clear_tx_outputs();
+    clear_rx_outputs();
+}
+
+void controller::clear_tx_outputs() {
+    // Clear all TX control outputs
     out_load_tx = false;
     out_load_tx2 = false;
     out_tx_start = false;
     out_tx_data = false;
     out_tx_parity = false;
     out_tx_stop = false;
+    out_tx_end = false;
+}
+
+void controller::clear_rx_outputs() {
+    // Clear all RX control outputs
     out_rx_start = false;
     out_rx_data = false;
     out_rx_parity = false;
     out_rx_stop = false;
-    out_rx_read = false;
-    out_error_handle = false;
 }
 
 void controller::read_inputs() {
-    // Read all input ports
     in_start = start.read();
     in_mem_we = mem_we.read();
+    read_tx_inputs();
+    read_rx_inputs();
+}
+
+void controller::read_tx_inputs() {
+    // Read the TX side input ports
     in_tx_buffer_full = tx_buffer_full.read();
-    in_rx_buffer_empty = rx_buffer_empty.read();
-    in_rx_in = rx_in.read();
-    in_parity_error = parity_error.read();
-    in_framing_error = framing_error.read();
-    in_overrun_error = overrun_error.read();
+    in_tx_buffer_empty = tx_buffer_empty.read();
+    in_tx_ready = tx_ready.read();
+    in_cts = cts.read();
+    in_tx_tick = tx_tick.read();
     
     // Read configuration
     in_parity_enabled = parity_enabled.read();
     in_parity_even = parity_even.read();
     in_data_bits = data_bits.read();
     in_stop_bits = stop_bits.read();
+    in_de_guard = de_guard.read();
 }
 
+void controller::read_rx_inputs() {
+    // Read the RX side input ports
+    in_rx_buffer_empty = rx_buffer_empty.read();
+    in_rx_tick = rx_tick.read();
+    in_rx_bit = rx_bit.read();
+    in_rx_in = rx_in.read();
+    in_parity_error = parity_error.read();
+    in_framing_error = framing_error.read();
+    in_overrun_error = overrun_error.read();
+    
+    // Read configuration, the RX thread keeps its own copy
+    in_rx_parity_enabled = parity_enabled.read();
+    in_rx_data_bits = data_bits.read();
+    in_rx_stop_bits = stop_bits.read();
+}
+
+// Both FSMs in one step, for the unit testbench
 void controller::controller_fsm() {
     // Skip if memory write is active
     if(in_mem_we) {
@@ -122,201 +228,232 @@ void controller::controller_fsm() {
     }
     else if(in_start) {
         // Reset on start signal
-        tx_state = TX_IDLE;
-        tx_next_state = TX_IDLE;
-        rx_state = RX_IDLE;
-        rx_next_state = RX_IDLE;
+        reset_control_clear_regs();
         in_start = false;
         return;
     }
-    else {
-        // Normal FSM operation
-        // First, clear all outputs from previous cycles
-        clear_output_sc_bits();
-        
-        // Update current state from next state
+    
+    tx_fsm();
+    rx_fsm();
+}
+
+void controller::tx_fsm() {
+    // First, clear all outputs from previous cycles
+    clear_tx_outputs();
+    
+    // TX states advance once per transmit bit period
+    if(in_tx_tick) {
+        // The tick after the last stop bit started ends the frame
+        out_tx_end = tx_done;
+        tx_done = false;
         tx_state = tx_next_state;
-        rx_state = rx_next_state;
-        
+    
         // TX FSM logic
         switch(tx_state.to_uint()) {
-            case TX_IDLE:
-                if(!in_tx_buffer_full) {
+            case CTRL_TX_IDLE:
+                // Keep driving the bus for the guard time after
+                // the last stop bit, then turn it around
+                if(de_guard_count != 0) {
+                    de_guard_count--;
+                } else {
+                    de_active = false;
+                }
+            
+                // Hold new frames while the far end has CTS down
+                if(!in_cts) {
+                    tx_next_state = CTRL_TX_IDLE;
+                } else if(in_tx_ready) {
+                    // Byte already prefetched into the holding register
+                    de_active = true;
+                    tx_next_state = CTRL_TX_START_BIT;
+                } else if(!in_tx_buffer_empty) {
+                    // Only fetch when the ring has a byte, an idle
+                    // transmitter must not start a frame
                     out_load_tx = true;
-                    tx_next_state = LOAD_TX2;
+                    tx_next_state = CTRL_TX_LOAD_WAIT;
                 } else {
-                    tx_next_state = TX_IDLE;
+                    tx_next_state = CTRL_TX_IDLE;
                 }
                 break;
-                
-            case LOAD_TX2:
+            
+            // Give the memory read one step to return before load_tx2,
+            // the datapath sees our outputs a step after we drive them
+            case CTRL_TX_LOAD_WAIT:
+                tx_next_state = CTRL_TX_LOAD2;
+                break;
+            
+            // Only reached with a byte in the ring, so the driver goes
+            // on for a real frame, a bit period ahead of its start bit
+            case CTRL_TX_LOAD2:
                 out_load_tx2 = true;
-                tx_next_state = TX_START_BIT;
+                de_active = true;
+                tx_next_state = CTRL_TX_START_BIT;
                 break;
-                
-            case TX_START_BIT:
+            
+            case CTRL_TX_START_BIT:
                 out_tx_start = true;
-                tx_next_state = TX_DATA_BITS;
+                tx_next_state = CTRL_TX_DATA_BITS;
                 tx_bit_counter = 0;
                 break;
-                
-            case TX_DATA_BITS:
+            
+            case CTRL_TX_DATA_BITS:
                 out_tx_data = true;
-                
+            
+                // Prefetch the next byte while this one is shifting out
+                if(tx_bit_counter == 0) {
+                    out_load_tx = true;
+                } else if(tx_bit_counter == 2) {
+                    out_load_tx2 = true;
+                }
+            
                 if(tx_bit_counter >= in_data_bits - 1) {
+                    // The counter goes on to count stop bits
+                    tx_bit_counter = 0;
                     if(in_parity_enabled) {
-                        tx_next_state = TX_PARITY_BIT;
+                        tx_next_state = CTRL_TX_PARITY_BIT;
                     } else {
-                        tx_next_state = TX_STOP_BIT;
+                        tx_next_state = CTRL_TX_STOP_BIT;
                     }
                 } else {
-                    tx_next_state = TX_DATA_BITS;
+                    tx_next_state = CTRL_TX_DATA_BITS;
                     tx_bit_counter++;
                 }
                 break;
-            case TX_PARITY_BIT:
+            case CTRL_TX_PARITY_BIT:
                 out_tx_parity = true;
-                tx_next_state = TX_STOP_BIT;
+                tx_next_state = CTRL_TX_STOP_BIT;
                 break;
-                
-            case TX_STOP_BIT:
+            
+            case CTRL_TX_STOP_BIT:
                 out_tx_stop = true;
-                
+            
                 if(in_stop_bits == 2 && tx_bit_counter == 0) {
                     tx_bit_counter = 1;
-                    tx_next_state = TX_STOP_BIT;
+                    tx_next_state = CTRL_TX_STOP_BIT;
                 } else {
-                    if(!in_tx_buffer_full) {
-                        tx_next_state = TX_IDLE;
-                        tx_done = true;
+                    tx_done = true;
+                    if(in_tx_ready && in_cts) {
+                        // Back-to-back: next start bit follows this stop bit
+                        tx_next_state = CTRL_TX_START_BIT;
                     } else {
-                        tx_next_state = TX_IDLE;
+                        de_guard_count = in_de_guard;
+                        tx_next_state = CTRL_TX_IDLE;
                     }
                 }
                 break;
-                
+            
             default:
-                tx_next_state = TX_IDLE;
+                tx_next_state = CTRL_TX_IDLE;
                 break;
         }
-        
+    }
+}
+
+void controller::rx_fsm() {
+    // First, clear all outputs from previous cycles
+    clear_rx_outputs();
+    
+    // RX states advance on the receiver's mid-bit ticks, each tick
+    // carries the voted value of one bit
+    if(in_rx_tick) {
+        rx_state = rx_next_state;
+    
         // RX FSM logic
         switch(rx_state.to_uint()) {
-            case RX_IDLE:
-                if(in_rx_in == true) {
+            case CTRL_RX_IDLE:
+                // The sampler only starts a frame on a verified start bit
+                if(in_rx_bit == false) {
                     out_rx_start = true;
-                    rx_next_state = RX_START_BIT;
-                } else {
-                    rx_next_state = RX_IDLE;
-                }
-                break;
-                
-            case RX_START_BIT:
-                out_rx_start = true;
-                
-                if(!in_rx_in) {
-                    rx_next_state = RX_IDLE;
-                } else {
-                    rx_next_state = RX_DATA_BITS;
+                    rx_next_state = CTRL_RX_DATA_BITS;
                     rx_bit_counter = 0;
+                } else {
+                    rx_next_state = CTRL_RX_IDLE;
                 }
                 break;
-                
-            case RX_DATA_BITS:  
+            
+            case CTRL_RX_DATA_BITS:  
                 // is asserting two control signals recommended???
 
                 out_rx_data = true;
-                
-                if(rx_bit_counter >= in_data_bits - 1) {
-                    if(in_parity_enabled) {
-                        rx_next_state = RX_PARITY_LOAD;
+            
+                if(rx_bit_counter >= in_rx_data_bits - 1) {
+                    if(in_rx_parity_enabled) {
+                        rx_next_state = CTRL_RX_PARITY_BIT;
                     } else {
-                        rx_next_state = RX_STOP_BIT;
+                        rx_next_state = CTRL_RX_STOP_BIT;
                     }
                 } else {
-                    rx_next_state = RX_DATA_BITS;
+                    rx_next_state = CTRL_RX_DATA_BITS;
                     rx_bit_counter++;
                 }
                 break;
             // Intermediate State so that datapath calcualtes parity and sends it back
 
-            case RX_PARITY_LOAD:
+            case CTRL_RX_PARITY_BIT:
                 out_rx_parity = true;
-                rx_next_state = RX_PARITY_CHECK;
+                rx_next_state = CTRL_RX_STOP_BIT;
                 break;
-                
-            case RX_PARITY_CHECK:
-                
-                if(in_parity_error) {
-                    rx_next_state = ERROR_HANDLING;
-                } else {
-                    rx_next_state = RX_STOP_BIT;
-                }
-                break;
-                
-            case RX_STOP_BIT:
+            
+            case CTRL_RX_STOP_BIT:
                 out_rx_stop = true;
-                
-                if(in_rx_in != 1) {
-                    rx_next_state = ERROR_HANDLING;
-                } else {
-                    if(in_stop_bits == 2 && rx_bit_counter == 0) {
-                        rx_bit_counter = 1;
-                        rx_next_state = RX_STOP_BIT;
-                    } else {
-                        rx_next_state = RX_IDLE;
-                        out_rx_read = true;
-                        rx_done = true;
-                    }
-                }
-                break;
-                
-            case ERROR_HANDLING:
-                out_error_handle = true;
-                rx_next_state = RX_IDLE;
+            
+                // Only the first stop bit is read. The sampler ends the
+                // frame here and hunts for the next start edge, so a
+                // second stop bit never reaches this FSM. The datapath
+                // checks the bit and tags the byte.
+                rx_next_state = CTRL_RX_IDLE;
                 break;
-                
+            
             default:
-                rx_next_state = RX_IDLE;
+                rx_next_state = CTRL_RX_IDLE;
                 break;
         }
     }
 }
 
 void controller::write_outputs() {
-    // Write to all output ports
+    write_tx_outputs();
+    write_rx_outputs();
+}
+
+void controller::write_tx_outputs() {
+    // Write the TX side output ports
     load_tx.write(out_load_tx);
     load_tx2.write(out_load_tx2);
     tx_start.write(out_tx_start);
     tx_data.write(out_tx_data);
     tx_parity.write(out_tx_parity);
     tx_stop.write(out_tx_stop);
+    tx_end.write(out_tx_end);
+    de.write(de_active);
+}
+
+void controller::write_rx_outputs() {
+    // Write the RX side output ports
     rx_start.write(out_rx_start);
     rx_data.write(out_rx_data);
     rx_parity.write(out_rx_parity);
     rx_stop.write(out_rx_stop);
-    rx_read.write(out_rx_read);
-    error_handle.write(out_error_handle);
 }
 
 bool controller::test_reset_controller() {
     // Check all state registers are reset
-    if(tx_state != TX_IDLE) {
+    if(tx_state != CTRL_TX_IDLE) {
         cout << "tx_state not reset: " << tx_state << endl;
         return false;
     }
     
-    if(rx_state != RX_IDLE) {
+    if(rx_state != CTRL_RX_IDLE) {
         cout << "rx_state not reset: " << rx_state << endl;
         return false;
     }
     
-    if(tx_next_state != TX_IDLE) {
+    if(tx_next_state != CTRL_TX_IDLE) {
         cout << "tx_next_state not reset: " << tx_next_state << endl;
         return false;
     }
     
-    if(rx_next_state != RX_IDLE) {
+    if(rx_next_state != CTRL_RX_IDLE) {
         cout << "rx_next_state not reset: " << rx_next_state << endl;
         return false;
     }
@@ -324,7 +461,7 @@ bool controller::test_reset_controller() {
         std::cout << "TX_BUFFER_NOT RESET" << std::endl;
     }
     if(!rx_buffer_empty){
-        std::cout < "RX_BUFFER_NOT_RESET" << std::endl;
+        std::cout << "RX_BUFFER_NOT_RESET" << std::endl;
     }
     
     // Check all outputs are reset
@@ -334,12 +471,11 @@ bool controller::test_reset_controller() {
     if(out_tx_data) return false;
     if(out_tx_parity) return false;
     if(out_tx_stop) return false;
+    if(out_tx_end) return false;
     if(out_rx_start) return false;
     if(out_rx_data) return false;
     if(out_rx_parity) return false;
     if(out_rx_stop) return false;
-    if(out_rx_read) return false;
-    if(out_error_handle) return false;
     
     return true;
 }
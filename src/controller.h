@@ -5,22 +5,27 @@
 #include "stratus_hls.h"
 #include "sizes.h"
 
-#define TX_IDLE 1
-#define RX_IDLE 1
-#define LOAD_TX2 2
-#define TX_START_BIT 3
-#define TX_DATA_BITS 4 
-#define TX_PARITY_BIT 5
-#define TX_STOP_BIT 6
-#define RX_START_BIT 2
-#define RX_DATA_BITS 3
-#define RX_PARITY_CHECK 4
-#define RX_STOP_BIT 5
-#define ERROR_HANDLING 6
-
-
-
 SC_MODULE(controller) {
+    // FSM states. Prefixed so they cannot collide with the shared
+    // state constants in sizes.h.
+    enum tx_states {
+        CTRL_TX_IDLE = 1,
+        CTRL_TX_LOAD2,
+        CTRL_TX_START_BIT,
+        CTRL_TX_DATA_BITS,
+        CTRL_TX_PARITY_BIT,
+        CTRL_TX_STOP_BIT,
+        CTRL_TX_LOAD_WAIT
+    };
+    
+    enum rx_states {
+        CTRL_RX_IDLE = 1,
+        CTRL_RX_START_BIT,
+        CTRL_RX_DATA_BITS,
+        CTRL_RX_PARITY_BIT,
+        CTRL_RX_STOP_BIT
+    };
+    
     // Clock and reset
     sc_in<bool> clk;                        // Port 0
     sc_in<bool> rst;                        // Port 1
@@ -31,33 +36,40 @@ SC_MODULE(controller) {
     
     // Status inputs
     sc_in<bool> tx_buffer_full;             // Port 4
-    sc_in<bool> rx_buffer_empty;            // Port 5
-    sc_in<bool> rx_in;                      // Port 6 - Serial input line
+    sc_in<bool> tx_buffer_empty;            // Port 5 - Nothing in the TX ring to load
+    sc_in<bool> rx_buffer_empty;            // Port 6
+    sc_in<bool> tx_ready;                   // Port 7 - Next TX byte prefetched
+    sc_in<bool> tx_tick;                    // Port 8 - Advance one TX bit period
+    sc_in<bool> rx_tick;                    // Port 9 - RX mid-bit sample ready
+    sc_in<bool> rx_bit;                     // Port 10 - Voted RX bit value
+    sc_in<bool> rx_in;                      // Port 11 - Serial input line
+    sc_in<bool> cts;                        // Port 12 - Clear to start a TX frame
     
     // Error inputs
-    sc_in<bool> parity_error;               // Port 7
-    sc_in<bool> framing_error;              // Port 8
-    sc_in<bool> overrun_error;              // Port 9
+    sc_in<bool> parity_error;               // Port 13
+    sc_in<bool> framing_error;              // Port 14
+    sc_in<bool> overrun_error;              // Port 15
     
     // Configuration inputs
-    sc_in<bool> parity_enabled;             // Port 10
-    sc_in<bool> parity_even;                // Port 11
-    sc_in<sc_uint<3>> data_bits;            // Port 12
-    sc_in<sc_uint<2>> stop_bits;            // Port 13
+    sc_in<bool> parity_enabled;             // Port 16
+    sc_in<bool> parity_even;                // Port 17
+    sc_in<sc_uint<4>> data_bits;            // Port 18
+    sc_in<sc_uint<2>> stop_bits;            // Port 19
+    sc_in<sc_uint<4>> de_guard;             // Port 20 - DE hold after the stop bit, in bit periods
     
     // Control outputs
-    sc_out<bool> load_tx;                   // Port 14
-    sc_out<bool> load_tx2;                  // Port 15
-    sc_out<bool> tx_start;                  // Port 16
-    sc_out<bool> tx_data;                   // Port 17
-    sc_out<bool> tx_parity;                 // Port 18
-    sc_out<bool> tx_stop;                   // Port 19
-    sc_out<bool> rx_start;                  // Port 20
-    sc_out<bool> rx_data;                   // Port 21
-    sc_out<bool> rx_parity;                 // Port 22
-    sc_out<bool> rx_stop;                   // Port 23
-    sc_out<bool> rx_read;                   // Port 24
-    sc_out<bool> error_handle;              // Port 25
+    sc_out<bool> load_tx;                   // Port 21
+    sc_out<bool> load_tx2;                  // Port 22
+    sc_out<bool> tx_start;                  // Port 23
+    sc_out<bool> tx_data;                   // Port 24
+    sc_out<bool> tx_parity;                 // Port 25
+    sc_out<bool> tx_stop;                   // Port 26
+    sc_out<bool> rx_start;                  // Port 27
+    sc_out<bool> rx_data;                   // Port 28
+    sc_out<bool> rx_parity;                 // Port 29
+    sc_out<bool> rx_stop;                   // Port 30
+    sc_out<bool> de;                        // Port 31 - RS-485 driver enable
+    sc_out<bool> tx_end;                    // Port 32 - Last stop bit of a frame is over
     
     // FSM state registers
     sc_bv<4> tx_state;
@@ -66,26 +78,37 @@ SC_MODULE(controller) {
     sc_bv<4> rx_next_state;
     
     // Internal registers and counters
-    int tx_bit_counter;
-    int rx_bit_counter;
+    sc_uint<4> tx_bit_counter;              // Data bits sent, then stop bits
+    sc_uint<4> rx_bit_counter;              // Data bits received
     bool tx_parity_value;
     bool rx_parity_value;
-    bool tx_done;
-    bool rx_done;
+    bool tx_done;                           // Last stop bit on the line, ends at the next tick
+    bool de_active;                         // Driver enable level
+    sc_uint<4> de_guard_count;              // Bit periods left before DE drops
     
     // Internal input values
     sc_bit in_start;
     sc_bit in_mem_we;
     sc_bit in_tx_buffer_full;
+    sc_bit in_tx_buffer_empty;
     sc_bit in_rx_buffer_empty;
+    sc_bit in_tx_ready;
+    sc_bit in_cts;
+    sc_bit in_tx_tick;
+    sc_bit in_rx_tick;
+    sc_bit in_rx_bit;
     sc_bit in_rx_in;
     sc_bit in_parity_error;
     sc_bit in_framing_error;
     sc_bit in_overrun_error;
     sc_bit in_parity_enabled;
     sc_bit in_parity_even;
-    sc_uint<3> in_data_bits;
+    sc_uint<4> in_data_bits;
     sc_uint<2> in_stop_bits;
+    sc_uint<4> in_de_guard;
+    sc_bit in_rx_parity_enabled;            // RX thread's copy of the frame format
+    sc_uint<4> in_rx_data_bits;
+    sc_uint<2> in_rx_stop_bits;
     
     // Internal output values
     sc_bit out_load_tx;
@@ -94,15 +117,29 @@ SC_MODULE(controller) {
     sc_bit out_tx_data;
     sc_bit out_tx_parity;
     sc_bit out_tx_stop;
+    sc_bit out_tx_end;
     sc_bit out_rx_start;
     sc_bit out_rx_data;
     sc_bit out_rx_parity;
     sc_bit out_rx_stop;
-    sc_bit out_rx_read;
-    sc_bit out_error_handle;
     
-    // Methods
-    void process();
+    // Thread bodies, one per direction
+    void process_tx();
+    void process_rx();
+    
+    // Per-direction methods, each only touches its own thread's state
+    void reset_tx_regs();
+    void reset_rx_regs();
+    void clear_tx_outputs();
+    void clear_rx_outputs();
+    void read_tx_inputs();
+    void read_rx_inputs();
+    void tx_fsm();
+    void rx_fsm();
+    void write_tx_outputs();
+    void write_rx_outputs();
+    
+    // Both directions at once
     void reset_control_clear_regs();
     void clear_output_sc_bits();
     void read_inputs();
@@ -113,7 +150,11 @@ SC_MODULE(controller) {
     bool test_reset_controller();
     
     SC_CTOR(controller) {
-        SC_THREAD(process);
+        SC_THREAD(process_tx);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, false);
+        
+        SC_THREAD(process_rx);
         sensitive << clk.pos();
         async_reset_signal_is(rst, false);
     }
@@ -127,27 +168,34 @@ public:
         ncsc_replace_name(start, "start");                  // Port 2
         ncsc_replace_name(mem_we, "mem_we");                // Port 3
         ncsc_replace_name(tx_buffer_full, "tx_buffer_full");// Port 4
-        ncsc_replace_name(rx_buffer_empty, "rx_buffer_empty");// Port 5
-        ncsc_replace_name(rx_in, "rx_in");                  // Port 6
-        ncsc_replace_name(parity_error, "parity_error");    // Port 7
-        ncsc_replace_name(framing_error, "framing_error");  // Port 8
-        ncsc_replace_name(overrun_error, "overrun_error");  // Port 9
-        ncsc_replace_name(parity_enabled, "parity_enabled");// Port 10
-        ncsc_replace_name(parity_even, "parity_even");      // Port 11
-        ncsc_replace_name(data_bits, "data_bits");          // Port 12
-        ncsc_replace_name(stop_bits, "stop_bits");          // Port 13
-        ncsc_replace_name(load_tx, "load_tx");              // Port 14
-        ncsc_replace_name(load_tx2, "load_tx2");            // Port 15
-        ncsc_replace_name(tx_start, "tx_start");            // Port 16
-        ncsc_replace_name(tx_data, "tx_data");              // Port 17
-        ncsc_replace_name(tx_parity, "tx_parity");          // Port 18
-        ncsc_replace_name(tx_stop, "tx_stop");              // Port 19
-        ncsc_replace_name(rx_start, "rx_start");            // Port 20
-        ncsc_replace_name(rx_data, "rx_data");              // Port 21
-        ncsc_replace_name(rx_parity, "rx_parity");          // Port 22
-        ncsc_replace_name(rx_stop, "rx_stop");              // Port 23
-        ncsc_replace_name(rx_read, "rx_read");              // Port 24
-        ncsc_replace_name(error_handle, "error_handle");    // Port 25
+        ncsc_replace_name(tx_buffer_empty, "tx_buffer_empty");// Port 5
+        ncsc_replace_name(rx_buffer_empty, "rx_buffer_empty");// Port 6
+        ncsc_replace_name(tx_ready, "tx_ready");            // Port 7
+        ncsc_replace_name(tx_tick, "tx_tick");              // Port 8
+        ncsc_replace_name(rx_tick, "rx_tick");              // Port 9
+        ncsc_replace_name(rx_bit, "rx_bit");                // Port 10
+        ncsc_replace_name(rx_in, "rx_in");                  // Port 11
+        ncsc_replace_name(cts, "cts");                      // Port 12
+        ncsc_replace_name(parity_error, "parity_error");    // Port 13
+        ncsc_replace_name(framing_error, "framing_error");  // Port 14
+        ncsc_replace_name(overrun_error, "overrun_error");  // Port 15
+        ncsc_replace_name(parity_enabled, "parity_enabled");// Port 16
+        ncsc_replace_name(parity_even, "parity_even");      // Port 17
+        ncsc_replace_name(data_bits, "data_bits");          // Port 18
+        ncsc_replace_name(stop_bits, "stop_bits");          // Port 19
+        ncsc_replace_name(de_guard, "de_guard");            // Port 20
+        ncsc_replace_name(load_tx, "load_tx");              // Port 21
+        ncsc_replace_name(load_tx2, "load_tx2");            // Port 22
+        ncsc_replace_name(tx_start, "tx_start");            // Port 23
+        ncsc_replace_name(tx_data, "tx_data");              // Port 24
+        ncsc_replace_name(tx_parity, "tx_parity");          // Port 25
+        ncsc_replace_name(tx_stop, "tx_stop");              // Port 26
+        ncsc_replace_name(rx_start, "rx_start");            // Port 27
+        ncsc_replace_name(rx_data, "rx_data");              // Port 28
+        ncsc_replace_name(rx_parity, "rx_parity");          // Port 29
+        ncsc_replace_name(rx_stop, "rx_stop");              // Port 30
+        ncsc_replace_name(de, "de");                        // Port 31
+        ncsc_replace_name(tx_end, "tx_end");                // Port 32
     }
 #endif
 };
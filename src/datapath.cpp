@@ -11,33 +11,17 @@
  
  using namespace std;
  
- // Memory map address definitions
- #define TX_BUFFER_START     0   // 16 bytes (0-15)
- #define RX_BUFFER_START    16   // 16 bytes (16-31)
- #define CONFIG_REG_START   32   // 6 bytes (32-37)
- #define STATUS_REG_START   38   // 2 bytes (38-39)
- 
- // Configuration register addresses
- #define BAUD_RATE_LOW      32   // Baud rate divisor (low byte)
- #define BAUD_RATE_HIGH     33   // Baud rate divisor (high byte)
- #define LINE_CONTROL_REG   34   // Line control register
- #define FIFO_CONTROL_REG   35   // FIFO control register
- #define SCRATCH_REG1       36   // Scratch register 1
- #define SCRATCH_REG2       37   // Scratch register 2
- 
- // Line control register bit definitions
- #define LCR_DATA_BITS_MASK 0x03 // Bits 0-1: Data bits (0=5, 1=6, 2=7, 3=8)
- #define LCR_STOP_BITS      0x04 // Bit 2: Stop bits (0=1, 1=2)
- #define LCR_PARITY_ENABLE  0x08 // Bit 3: Parity enable
- #define LCR_PARITY_EVEN    0x10 // Bit 4: Even parity when set, odd when clear
- #define LCR_STICK_PARITY   0x20 // Bit 5: Stick parity
- #define LCR_BREAK_CONTROL  0x40 // Bit 6: Break control
- #define LCR_DLAB           0x80 // Bit 7: Divisor latch access bit
- 
- void datapath::process() {
+ // TX and RX run as separate threads that share only the ports to the
+ // controller and memory map. Each keeps its own copy of the frame
+ // format and its own baud divider, so neither direction's schedule or
+ // critical path holds up the other. Reset drives the ports as well as
+ // the registers, so no level from before a reset reaches the other
+ // modules once it is released.
+ void datapath::tx_process() {
      {
          HLS_DEFINE_PROTOCOL("reset");
-         reset();
+         reset_tx();
+         write_tx_outputs();
      }
      
      {       
@@ -49,26 +33,26 @@
          // Read inputs
          {
              HLS_DEFINE_PROTOCOL("input");
-             read_inputs();
+             read_tx_inputs();
          }
          
          // Check if memory write is active
-         if(!in_mem_we) {
-             if(in_start) {
+         if(!mem_we.read()) {
+             if(start.read()) {
                  {
                      HLS_DEFINE_PROTOCOL("start");
-                     reset();
+                     reset_tx();
                  }
              } else {
                  {
-                     HLS_DEFINE_PROTOCOL("datapath_ops");
-                     compute();
+                     HLS_DEFINE_PROTOCOL("tx_ops");
+                     tx_compute();
                  }
                  
                  {
                      HLS_DEFINE_PROTOCOL("output");
-                     commit();
-                     write_outputs();
+                     commit_tx();
+                     write_tx_outputs();
                  }
              }
          }
@@ -79,61 +63,254 @@
              wait();
          }
          
+#if !UART_SINGLE_CYCLE
          // Additional wait for processing time
          {       
              HLS_DEFINE_PROTOCOL("wait");
              wait();
          }
+#endif
      }
  }
  
- void datapath::reset() {
+ void datapath::rx_process() {
+     {
+         HLS_DEFINE_PROTOCOL("reset");
+         reset_rx();
+         write_rx_outputs();
+     }
+     
+     {       
+         HLS_DEFINE_PROTOCOL("wait");
+         wait();
+     }
+     
+     while(true) {
+         // Read inputs
+         {
+             HLS_DEFINE_PROTOCOL("input");
+             read_rx_inputs();
+         }
+         
+         // Check if memory write is active
+         if(!mem_we.read()) {
+             if(start.read()) {
+                 {
+                     HLS_DEFINE_PROTOCOL("start");
+                     reset_rx();
+                 }
+             } else {
+                 {
+                     HLS_DEFINE_PROTOCOL("rx_ops");
+                     rx_compute();
+                 }
+                 
+                 {
+                     HLS_DEFINE_PROTOCOL("output");
+                     commit_rx();
+                     write_rx_outputs();
+                 }
+             }
+         }
+         
+         // Wait for next cycle
+         {       
+             HLS_DEFINE_PROTOCOL("wait");
+             wait();
+         }
+         
+#if !UART_SINGLE_CYCLE
+         // Additional wait for processing time
+         {       
+             HLS_DEFINE_PROTOCOL("wait");
+             wait();
+         }
+#endif
+     }
+ }
+ 
+ void datapath::reset_tx() {
      load_tx_phase = false;
  
-     // Reset transmit and receive registers
+     // Reset transmit registers
+     tx_holding_register = 0;
+     tx_holding_valid = false;
      tx_shift_register = 0;
-     rx_shift_register = 0;
+     tx_addr_bit = false;
+     tx_parity_bit = false;
+     tx_frame_valid = false;
+     tx_framing = FRAMING_OFF;
+     slip_tx_escape = 0;
+     slip_tx_end = false;
      
      // Reset buffer pointers
      tx_buf_head = 0;
      tx_buf_tail = 0;
-     rx_buf_head = 0;
-     rx_buf_tail = 0;
-     
-     // Reset bit counters
-     tx_bit_count = 0;
-     rx_bit_count = 0;
      
      // Reset output signals
      out_tx_out = 1;  // Idle state is high
+     tx_line = 1;
      out_tx_buffer_full = false;
+     out_tx_ready = false;
+     out_addr = TX_BUFFER_START;
+     
+     // Reset baud rate generation
+     tx_baud_divider = 0x0003;  // Default baud rate divisor
+     tx_baud_fraction = 0;
+     tx_baud_counter = 0;
+     tx_baud_frac_acc = 0;
+     tx_osr_ratio = 16;
+     tx_os_count = 0;
+     out_tx_tick = false;
+     
+     // Reset flow control
+     tx_modem_control = 0;
+     cts_sync = 3;
+     out_cts = true;
+     tx_flow_char = 0;
+     tx_xoff_sent = false;
+     
+     // Reset frame timestamp event
+     ts_tx_toggle = false;
+     
+     // Reset RS-485 turnaround
+     tx_rs485_control = 0;
+     out_de_out = false;
+     
+     // Reset frame check engine
+     tx_crc_mode = CRC_MODE_OFF;
+     tx_crc_clear = false;
+     tx_crc_reg = 0;
+     
+     // Reset configuration
+     break_control = false;
+     tx_multidrop = false;
+     tx_parity_enabled = false;
+     tx_parity_even = true;
+     tx_data_bits = 8;
+     
+     // Reset controller config outputs
+     out_ctrl_parity_enabled = false;
+     out_ctrl_parity_even = true;
+     out_ctrl_data_bits = 8;
+     out_ctrl_stop_bits = 1;
+     out_ctrl_de_guard = 0;
+     
+     // Reset internal next-state values
+     next_load_tx_phase = false;
+     next_tx_buf_tail = 0;
+     next_tx_holding_register = 0;
+     next_tx_holding_valid = false;
+     next_tx_buffer_full = false;
+     next_tx_out = 1;
+     next_tx_shift_register = 0;
+     next_tx_frame_valid = false;
+     next_tx_addr_bit = false;
+     next_tx_parity_bit = false;
+     next_tx_flow_char = 0;
+     next_tx_xoff_sent = false;
+     next_slip_tx_escape = 0;
+     next_slip_tx_end = false;
+     next_tx_crc_reg = 0;
+ }
+ 
+ void datapath::reset_rx() {
+     // Reset receive registers
+     rx_shift_register = 0;
+     rx_frame_tags = 0;
+     rx_frame_zero = false;
+     rx_break_hold = false;
+     rx_addr_bit = false;
+     rx_addressed = false;
+     rx_framing = FRAMING_OFF;
+     slip_rx_escape = false;
+     slip_rx_staged = false;
+     slip_rx_stage = 0;
+     slip_rx_stage_stamp = 0;
+     
+     // Reset buffer pointers
+     rx_buf_head = 0;
+     rx_buf_tail = 0;
+     
+     // Reset output signals
      out_rx_buffer_empty = true;
      out_parity_error = false;
      out_framing_error = false;
      out_overrun_error = false;
-     out_data_out = 0;
+     out_dp_data_in = 0;
+     out_dp_addr = 0;
      out_dp_write_enable = false;
+     out_dp_ts_data = 0;
      
      // Reset baud rate generation
      baud_divider = 0x0003;  // Default baud rate divisor
+     baud_fraction = 0;
      baud_counter = 0;
+     baud_frac_acc = 0;
+     sample_tick = false;
+     osr_ratio = 16;
+     
+     // Reset receiver front-end
+     rx_sync = 3;     // Line idles high
+     rx_samples = 7;
+     rx_sampling = false;
+     rx_os_count = 0;
+     rx_frame_bits = 0;
+     rx_bit_value = true;
+     out_rx_tick = false;
+     out_rx_bit = true;
+     
+     // Reset autobaud detector
+     rx_control = 0;
+     autobaud_state = AB_OFF;
+     autobaud_count = 0;
+     autobaud_edges = 0;
+     autobaud_prev = true;
+     autobaud_step = 0;
+     autobaud_divisor = 0;
+     autobaud_fraction = 0;
+     
+     // Reset flow control
+     modem_control = 0;
+     rts_threshold = RTS_THRESHOLD_DEFAULT;
+     rts_state = true;
+     out_rts_out = true;
+     rx_peer_xoff = false;
+     rx_edge_stamp = 0;
+     rx_frame_stamp = 0;
+     
+     // Reset RS-485 echo suppression
+     rs485_control = 0;
+     
+     // Reset interrupt logic
+     fifo_control = 0x01;
+     int_enable = 0;
+     out_irq = false;
+     out_int_id = IIR_NONE;
+     rx_timeout_count = 0;
+     out_rx_timeout = false;
+     
+     // Reset character match
+     match_char = 0;
+     match_valid = false;
+     match_ring_index = 0;
+     out_match_pending = false;
+     
+     // Reset frame check engine
+     rx_crc_mode = CRC_MODE_OFF;
+     rx_crc_clear = false;
+     rx_crc_reg = 0;
      
      // Reset configuration
+     multidrop = false;
+     station_addr = 0;
+     station_mask = 0xFF;
      parity_enabled = false;
      parity_even = true;
      data_bits = 8;
      stop_bits = 1;
      
-     // Reset controller config outputs
-     out_ctrl_parity_enabled = false;
-     out_ctrl_parity_even = true;
-     out_ctrl_data_bits = 8;
-     out_ctrl_stop_bits = 1;
-     
      // Reset internal next-state values
-     next_tx_buffer_full = false;
-     next_tx_out = 1;
-     next_tx_shift_register = 0;
      next_rx_buffer_empty = true;
      next_rx_buf_head = 0;
      next_rx_buf_tail = 0;
@@ -141,70 +318,229 @@
      next_framing_error = false;
      next_overrun_error = false;
      next_rx_shift_register = 0;
-     next_data_out = 0;
+     next_rx_frame_tags = 0;
+     next_rx_frame_zero = false;
+     next_rx_frame_stamp = 0;
+     next_rx_addr_bit = false;
+     next_rx_addressed = false;
+     next_rx_peer_xoff = false;
+     next_rx_break_hold = false;
+     next_rx_sampling = false;
+     next_slip_rx_escape = false;
+     next_slip_rx_staged = false;
+     next_slip_rx_stage = 0;
+     next_slip_rx_stage_stamp = 0;
+     next_match_valid = false;
+     next_match_ring_index = 0;
+     next_rx_crc_reg = 0;
  }
  
- void datapath::read_inputs() {
-     // Read all input ports
-     in_start = start.read();
-     in_mem_we = mem_we.read();
+ void datapath::read_tx_inputs() {
+     // Read the TX side input ports
      in_load_tx = load_tx.read();
      in_load_tx2 = load_tx2.read();
      in_tx_start = tx_start.read();
      in_tx_data = tx_data.read();
      in_tx_parity = tx_parity.read();
      in_tx_stop = tx_stop.read();
+     in_tx_end = tx_end.read();
+     in_cts_in = cts_in.read();
+     in_de = de.read();
+     in_data_in = data_in.read();
+     in_tx_head = tx_head.read();
+     in_xoff_wanted = xoff_wanted.read();
+     in_peer_xoff = peer_xoff.read();
+     in_tx_cfg_line_control = cfg_line_control.read();
+     in_tx_cfg_baud_divisor = cfg_baud_divisor.read();
+     in_tx_cfg_baud_fraction = cfg_baud_fraction.read();
+     in_tx_cfg_rx_control = cfg_rx_control.read();
+     in_tx_cfg_modem_control = cfg_modem_control.read();
+     in_tx_cfg_rs485_control = cfg_rs485_control.read();
+     in_tx_cfg_crc_control = cfg_crc_control.read();
+     in_tx_cfg_framing_control = cfg_framing_control.read();
+ }
+ 
+ void datapath::read_rx_inputs() {
+     // Read the RX side input ports
      in_rx_start = rx_start.read();
      in_rx_data = rx_data.read();
      in_rx_parity = rx_parity.read();
      in_rx_stop = rx_stop.read();
-     in_error_handle = error_handle.read();
-     in_rx_read = rx_read.read();
      in_rx_in = rx_in.read();
-     in_data_in = data_in.read();
+     in_rx_de = de.read();
+     in_ts_count = ts_count.read();
+     in_rx_tail = rx_tail.read();
+     in_tx_fill = tx_fill_level.read();
+     in_cfg_line_control = cfg_line_control.read();
+     in_cfg_baud_divisor = cfg_baud_divisor.read();
+     in_cfg_baud_fraction = cfg_baud_fraction.read();
+     in_cfg_fifo_control = cfg_fifo_control.read();
+     in_cfg_rx_control = cfg_rx_control.read();
+     in_cfg_modem_control = cfg_modem_control.read();
+     in_cfg_rts_threshold = cfg_rts_threshold.read();
+     in_cfg_int_enable = cfg_int_enable.read();
+     in_cfg_station = cfg_station.read();
+     in_cfg_rs485_control = cfg_rs485_control.read();
+     in_cfg_crc_control = cfg_crc_control.read();
+     in_cfg_framing_control = cfg_framing_control.read();
+     in_cfg_match_char = cfg_match_char.read();
  }
  
- void datapath::write_outputs() {
-     // Write to all output ports
+ void datapath::write_tx_outputs() {
+     // Write the TX side output ports
      tx_buffer_full.write(out_tx_buffer_full);
-     rx_buffer_empty.write(out_rx_buffer_empty);
-     parity_error.write(out_parity_error);
-     framing_error.write(out_framing_error);
-     overrun_error.write(out_overrun_error);
+     tx_buffer_empty.write(tx_buf_head == tx_buf_tail);
+     tx_tick.write(out_tx_tick);
+     tx_ready.write(out_tx_ready);
+     cts.write(out_cts);
      ctrl_parity_enabled.write(out_ctrl_parity_enabled);
      ctrl_parity_even.write(out_ctrl_parity_even);
      ctrl_data_bits.write(out_ctrl_data_bits);
      ctrl_stop_bits.write(out_ctrl_stop_bits);
+     ctrl_de_guard.write(out_ctrl_de_guard);
      tx_out.write(out_tx_out);
-     data_out.write(out_data_out);
+     de_out.write(out_de_out);
      addr.write(out_addr);
+     tx_tail.write(tx_buf_tail);
+     tx_fill_level.write(tx_buf_head - tx_buf_tail);
+     tx_crc.write(crc_result(tx_crc_reg, tx_crc_mode));
+     ts_tx_event.write(ts_tx_toggle);
+     tx_idle.write(!tx_frame_valid && !out_tx_ready);
+ }
+ 
+ void datapath::write_rx_outputs() {
+     // Write the RX side output ports
+     rx_buffer_empty.write(out_rx_buffer_empty);
+     parity_error.write(out_parity_error);
+     framing_error.write(out_framing_error);
+     overrun_error.write(out_overrun_error);
+     rx_tick.write(out_rx_tick);
+     rx_bit.write(out_rx_bit);
+     rx_timeout.write(out_rx_timeout);
+     irq.write(out_irq);
+     int_id.write(out_int_id);
+     match_pending.write(out_match_pending);
+     match_index.write(match_ring_index);
+     rts_out.write(out_rts_out);
      dp_data_in.write(out_dp_data_in);
      dp_addr.write(out_dp_addr);
      dp_write_enable.write(out_dp_write_enable);
+     dp_ts_data.write(out_dp_ts_data);
+     rx_head.write(rx_buf_head);
+     rx_crc.write(crc_result(rx_crc_reg, rx_crc_mode));
+     xoff_wanted.write((modem_control & MCR_XON_XOFF) != 0 && !rts_state);
+     peer_xoff.write(rx_peer_xoff);
+ }
+ 
+ void datapath::tx_compute() {
+     // Reset logic, active low like the thread reset
+     if (!rst.read()) {
+         reset_tx();
+         return;
+     }
+     
+     // Every step below works on the next-state values, which start as
+     // the current state; commit_tx is the only place registers change
+     hold_tx_state();
+     
+     update_tx_configuration();
+     update_baud_tick();
+     update_xon_xoff();
+     compute_tx();
+     update_cts();
+     update_tx_timestamp();
+     update_driver_enable();
  }
  
- void datapath::compute() {
-     // Reset logic
-     if (rst.read()) {
-         reset();
+ void datapath::rx_compute() {
+     // Reset logic, active low like the thread reset
+     if (!rst.read()) {
+         reset_rx();
          return;
      }
      
+     // Write enable is a single-cycle pulse
+     out_dp_write_enable = false;
+     
+     // As on the TX side, registers only change in commit_rx
+     hold_rx_state();
+     
      // First, update configuration from memory map
      update_configuration();
      
-     // Process TX and RX independently
-     compute_tx();
+     // Advance the baud rate generator and the receiver front-end
+     update_sample_tick();
+     update_rx_sampler();
+     
      compute_rx();
+     update_rts();
+     update_rx_timeout();
+     update_char_match();
+     update_interrupts();
+     
+     // Autobaud write-back shares the memory write port with RX
+     update_autobaud();
  }
  
- // New method to read and interpret configuration registers
- void datapath::update_configuration() {
-     // Request configuration register values by setting address
-     out_addr = LINE_CONTROL_REG;
+ // Decode the configuration shadows for the TX thread, from its own
+ // in_tx_cfg_* copies; the in_cfg_* copies belong to the RX thread.
+ void datapath::update_tx_configuration() {
+     sc_uint<DATA_W> lcr = in_tx_cfg_line_control;
+     sc_uint<DATA_W> rxc = in_tx_cfg_rx_control;
+     
+     tx_data_bits = (lcr & LCR_DATA_BITS_MASK) + 5;
+     tx_parity_enabled = (lcr & LCR_PARITY_ENABLE) != 0;
+     tx_parity_even = (lcr & LCR_PARITY_EVEN) != 0;
+     break_control = (lcr & LCR_BREAK_CONTROL) != 0;
+     
+     // Multidrop takes over the parity slot, so the controller still
+     // has to run the parity state for the address bit
+     tx_multidrop = (rxc & RXC_MULTIDROP) != 0;
      
-     // Read line control register - in real hardware this would have a delay
-     sc_uint<DATA_W> lcr = in_data_in;
+     // Update controller configuration outputs
+     out_ctrl_parity_enabled = tx_parity_enabled || tx_multidrop;
+     out_ctrl_parity_even = tx_parity_even;
+     out_ctrl_data_bits = tx_data_bits;
+     out_ctrl_stop_bits = ((lcr & LCR_STOP_BITS) != 0) ? 2 : 1;
+     
+     // Baud rate divisor, fraction and oversampling ratio
+     tx_baud_divider = in_tx_cfg_baud_divisor;
+     tx_baud_fraction = in_tx_cfg_baud_fraction;
+     switch (rxc & RXC_OSR_MASK) {
+         case 1:  tx_osr_ratio = 8;  break;
+         case 2:  tx_osr_ratio = 4;  break;
+         default: tx_osr_ratio = 16; break;
+     }
+     
+     // Auto-CTS and RS-485 turnaround, the guard time is counted by
+     // the controller
+     tx_modem_control = in_tx_cfg_modem_control;
+     tx_rs485_control = in_tx_cfg_rs485_control;
+     out_ctrl_de_guard = (tx_rs485_control & RSC_GUARD_MASK) >> RSC_GUARD_SHIFT;
+     
+     // TX byte-stuffing framer. Turning it off drops a pending escape.
+     tx_framing = in_tx_cfg_framing_control & FRC_TX_MASK;
+     if (tx_framing != FRAMING_SLIP) {
+         next_slip_tx_escape = 0;
+         next_slip_tx_end = false;
+     }
+     
+     // A new mode or a clear request restarts the TX CRC
+     sc_uint<DATA_W> crc = in_tx_cfg_crc_control;
+     bool clear = (crc & CRC_TX_CLEAR) != 0;
+     if ((crc & CRC_MODE_MASK) != tx_crc_mode || clear != tx_crc_clear) {
+         tx_crc_mode = crc & CRC_MODE_MASK;
+         tx_crc_clear = clear;
+         next_tx_crc_reg = crc_seed(tx_crc_mode);
+     }
+ }
+ 
+ // Decode the configuration shadows for the RX thread. The memory map
+ // only changes them when a register is written, by the host or by the
+ // autobaud write-back, so configuration takes no cycles on the memory
+ // port.
+ void datapath::update_configuration() {
+     sc_uint<DATA_W> lcr = in_cfg_line_control;
      
      // Extract configuration parameters
      data_bits = (lcr & LCR_DATA_BITS_MASK) + 5;  // Convert to actual number (5-8)
@@ -212,62 +548,401 @@
      parity_enabled = (lcr & LCR_PARITY_ENABLE) != 0;
      parity_even = (lcr & LCR_PARITY_EVEN) != 0;
      
-     // Update controller configuration outputs
-     out_ctrl_parity_enabled = parity_enabled;
-     out_ctrl_parity_even = parity_even;
-     out_ctrl_data_bits = data_bits;
-     out_ctrl_stop_bits = stop_bits;
+     // Multidrop address filter
+     multidrop = (in_cfg_rx_control & RXC_MULTIDROP) != 0;
+     station_addr = in_cfg_station.range(7, 0);
+     station_mask = in_cfg_station.range(15, 8);
+     
+     // Baud rate divisor and fraction
+     baud_divider = in_cfg_baud_divisor;
+     baud_fraction = in_cfg_baud_fraction;
+ 
+     // Oversampling ratio
+     rx_control = in_cfg_rx_control;
+     switch (rx_control & RXC_OSR_MASK) {
+         case 1:  osr_ratio = 8;  break;
+         case 2:  osr_ratio = 4;  break;
+         default: osr_ratio = 16; break;
+     }
+ 
+     // Flow control, FIFO control and interrupt enable
+     modem_control = in_cfg_modem_control;
+     if ((modem_control & MCR_XON_XOFF) == 0) {
+         next_rx_peer_xoff = false;
+     }
+     rts_threshold = in_cfg_rts_threshold;
+     fifo_control = in_cfg_fifo_control;
+     int_enable = in_cfg_int_enable;
+     match_char = in_cfg_match_char;
      
-     // Read baud rate divisor
-     out_addr = BAUD_RATE_LOW;
-     sc_uint<DATA_W> baud_low = in_data_in;
+     // RS-485 echo suppression
+     rs485_control = in_cfg_rs485_control;
      
-     out_addr = BAUD_RATE_HIGH;
-     sc_uint<DATA_W> baud_high = in_data_in;
+     // RX de-framer. Turning it off abandons a partial frame.
+     rx_framing = (in_cfg_framing_control & FRC_RX_MASK) >> FRC_RX_SHIFT;
+     if (rx_framing != FRAMING_SLIP) {
+         next_slip_rx_escape = false;
+         next_slip_rx_staged = false;
+     }
      
-     // Combine to form 16-bit baud rate divisor
-     baud_divider = (baud_high << 8) | baud_low;
+     // A new mode or a clear request restarts the RX CRC
+     bool crc_clear = (in_cfg_crc_control & CRC_RX_CLEAR) != 0;
+     if ((in_cfg_crc_control & CRC_MODE_MASK) != rx_crc_mode || crc_clear != rx_crc_clear) {
+         rx_crc_mode = in_cfg_crc_control & CRC_MODE_MASK;
+         rx_crc_clear = crc_clear;
+         next_rx_crc_reg = crc_seed(rx_crc_mode);
+     }
  }
  
- // TX compute method
- void datapath::compute_tx() {
-     // Reset TX next-state values to defaults
+ // Fractional baud divider - true once per divisor period, where a
+ // period is divider + fraction/256 loop iterations. The fraction is
+ // accumulated and every carry stretches one period by an iteration.
+ // Each thread runs its own copy on its own counter.
+ bool datapath::baud_divide(sc_uint<16>& counter, sc_uint<8>& frac_acc,
+                            sc_uint<16> divider, sc_uint<8> fraction) {
+     if (counter == 0) {
+         sc_uint<9> acc = frac_acc + fraction;
+         frac_acc = acc.range(7, 0);
+         
+         if (divider > 1) {
+             counter = divider - 1 + acc[8];
+         } else {
+             counter = acc[8];
+         }
+         return true;
+     }
+     
+     counter--;
+     return false;
+ }
+ 
+ // TX bit clock. A TX bit lasts tx_osr_ratio divider periods, so the
+ // line rate is clock / (divisor * osr_ratio), the same as the
+ // receiver's.
+ void datapath::update_baud_tick() {
+     out_tx_tick = false;
+     
+     if (baud_divide(tx_baud_counter, tx_baud_frac_acc, tx_baud_divider, tx_baud_fraction)) {
+         if (tx_os_count >= tx_osr_ratio - 1) {
+             tx_os_count = 0;
+             out_tx_tick = true;
+         } else {
+             tx_os_count++;
+         }
+     }
+ }
+ 
+ // RX oversampling tick, one per divider period
+ void datapath::update_sample_tick() {
+     sample_tick = baud_divide(baud_counter, baud_frac_acc, baud_divider, baud_fraction);
+ }
+ 
+ // Oversampling receiver front-end. Idles until a falling edge on the
+ // synchronized rx_in, then counts sample ticks from that edge. One
+ // sample past each mid-bit point the three samples around it are
+ // majority-voted and handed to the controller with rx_tick. A start
+ // bit that votes high is treated as a glitch. Every frame restarts
+ // from its own start edge, so clock mismatch cannot accumulate.
+ void datapath::update_rx_sampler() {
+     out_rx_tick = false;
+     
+     // Two-flop synchronizer on the asynchronous serial input. With
+     // echo suppression the receiver sees mark while our own driver
+     // is on the bus, i.e. while de_out is up, not just the request.
+     bool driving = (rs485_control & RSC_DE_ENABLE) != 0 && in_rx_de;
+     bool echo = (rs485_control & RSC_ECHO_SUPPRESS) != 0 && driving;
+     rx_sync[1] = rx_sync[0];
+     rx_sync[0] = (bool)in_rx_in || echo;
+     
+     // The detector owns the line while autobaud is armed
+     if (autobaud_state != AB_OFF) {
+         next_rx_sampling = false;
+         return;
+     }
+     
+     // Between sample ticks the frame in progress is kept as it is
+     if (!sample_tick) {
+         return;
+     }
+     
+     rx_samples = (rx_samples << 1) | rx_sync[1];
+     
+     // After a break, wait for the line to return to mark before
+     // hunting for the next start bit
+     if (rx_break_hold) {
+         if (rx_samples[0] == 1) {
+             next_rx_break_hold = false;
+         }
+         return;
+     }
+     
+     if (!rx_sampling) {
+         // Falling edge: previous sample high, this one low
+         if (rx_samples[1] == 1 && rx_samples[0] == 0) {
+             next_rx_sampling = true;
+             rx_os_count = 0;
+             rx_frame_bits = 0;
+             
+             // Start edge for the RX timestamp, kept until the
+             // controller confirms the start bit
+             rx_edge_stamp = in_ts_count;
+         }
+         return;
+     }
+     
+     if (rx_os_count >= osr_ratio - 1) {
+         rx_os_count = 0;
+     } else {
+         rx_os_count++;
+     }
+     
+     if (rx_os_count == (osr_ratio >> 1) + 1) {
+         bool voted = sample_vote(rx_samples);
+         
+         if (rx_frame_bits == 0 && voted) {
+             // Not a real start bit, go back to hunting for an edge
+             next_rx_sampling = false;
+             return;
+         }
+         
+         rx_bit_value = voted;
+         out_rx_bit = voted;
+         out_rx_tick = true;
+         rx_frame_bits++;
+         
+         // Stop after the first stop bit and wait for the next edge. A
+         // second stop bit is never handed to the controller, so a space
+         // there cannot be taken for the next start bit.
+         sc_uint<4> frame_bits = 1 + data_bits + ((parity_enabled || multidrop) ? 1 : 0) + 1;
+         if (rx_frame_bits >= frame_bits) {
+             next_rx_sampling = false;
+         }
+     }
+ }
+ 
+ // Automatic baud-rate detection. Once armed through RX_CONTROL_REG it
+ // counts loop iterations from the start edge to a known edge:
+ //   start bit mode - the first rising edge, 1 bit time (LSB must be 1)
+ //   0x55 mode      - the 4th falling edge after the start, 8 bit times
+ //   'A'/'a' mode   - the 2nd falling edge after the start, 8 bit times
+ // The count is turned into divisor + fraction for the current
+ // oversampling ratio and written back to BAUD_RATE_LOW/HIGH/FRAC, then
+ // the autobaud bits in RX_CONTROL_REG are cleared to report completion.
+ void datapath::update_autobaud() {
+     sc_uint<2> mode = (rx_control & RXC_AUTOBAUD_MASK) >> RXC_AUTOBAUD_SHIFT;
+     bool level = rx_sync[1];
+     bool falling = autobaud_prev && !level;
+     bool rising = !autobaud_prev && level;
+     autobaud_prev = level;
+     
+     switch (autobaud_state) {
+         case AB_OFF:
+             if (mode != 0) {
+                 autobaud_state = AB_WAIT_EDGE;
+             }
+             break;
+             
+         case AB_WAIT_EDGE:
+             if (mode == 0) {
+                 autobaud_state = AB_OFF;
+             } else if (falling) {
+                 autobaud_count = 1;
+                 autobaud_edges = 0;
+                 autobaud_state = AB_MEASURE;
+             }
+             break;
+             
+         case AB_MEASURE: {
+             bool done = false;
+             sc_uint<3> shift;
+             
+             if (mode == 1) {
+                 done = rising;
+                 shift = 0;              // 1 bit time
+             } else {
+                 if (falling) {
+                     autobaud_edges++;
+                 }
+                 done = falling && autobaud_edges == ((mode == 2) ? 4 : 2);
+                 shift = 3;              // 8 bit times
+             }
+             
+             if (done) {
+                 autobaud_rate(autobaud_count, shift, osr_ratio,
+                               autobaud_divisor, autobaud_fraction);
+                 autobaud_step = 0;
+                 autobaud_state = AB_WRITEBACK;
+             } else if (autobaud_count != 0xFFFFFF) {
+                 autobaud_count++;  // Saturates on a stuck line
+             }
+             break;
+         }
+             
+         case AB_WRITEBACK:
+             // One register per cycle, yield to an RX store
+             if (!out_dp_write_enable) {
+                 out_dp_write_enable = true;
+                 switch (autobaud_step) {
+                     case 0:
+                         out_dp_addr = BAUD_RATE_LOW;
+                         out_dp_data_in = autobaud_divisor.range(7, 0);
+                         break;
+                     case 1:
+                         out_dp_addr = BAUD_RATE_HIGH;
+                         out_dp_data_in = autobaud_divisor.range(15, 8);
+                         break;
+                     case 2:
+                         out_dp_addr = BAUD_RATE_FRAC;
+                         out_dp_data_in = autobaud_fraction;
+                         break;
+                     default:
+                         out_dp_addr = RX_CONTROL_REG;
+                         out_dp_data_in = rx_control & ~RXC_AUTOBAUD_MASK;
+                         autobaud_state = AB_DONE;
+                         break;
+                 }
+                 autobaud_step++;
+             }
+             break;
+             
+         default:
+             // Wait for the cleared mode bits to read back
+             if (mode == 0) {
+                 autobaud_state = AB_OFF;
+             }
+             break;
+     }
+ }
+ 
+ // Next-state values for this iteration, starting from the current state
+ void datapath::hold_tx_state() {
      next_tx_buffer_full = out_tx_buffer_full;
-     next_tx_out = out_tx_out;
+     next_tx_out = tx_line;
      next_tx_shift_register = tx_shift_register;
+     next_tx_buf_tail = tx_buf_tail;
+     next_load_tx_phase = load_tx_phase;
+     next_tx_holding_register = tx_holding_register;
+     next_tx_holding_valid = tx_holding_valid;
+     next_tx_frame_valid = tx_frame_valid;
+     next_tx_addr_bit = tx_addr_bit;
+     next_tx_parity_bit = tx_parity_bit;
+     next_tx_flow_char = tx_flow_char;
+     next_tx_xoff_sent = tx_xoff_sent;
+     next_slip_tx_escape = slip_tx_escape;
+     next_slip_tx_end = slip_tx_end;
+     next_tx_crc_reg = tx_crc_reg;
+ }
+ 
+ // TX compute method
+ void datapath::compute_tx() {
+     // The host advances the head through the data port
+     tx_buf_head = in_tx_head;
      
      // Handle TX operations based on control signals
-     if (in_load_tx) {
+     // load_tx/load_tx2 fill the holding register from the ring. The
+     // controller also pulses them while data bits are shifting, so the
+     // next byte is waiting when the stop bit finishes.
+     if (in_load_tx && !tx_holding_valid && !load_tx_phase) {
          if (tx_buf_head != tx_buf_tail) {
-             if (!load_tx_phase) {
-                 // First phase: Set up the memory address
-                 unsigned int mem_addr = tx_buf_tail; // TX buffer starts at address 0
-                 out_addr = mem_addr; // Set address to read from Memory
-                 load_tx_phase = true; // Move to second phase next time
-             }
+             // First phase: Set up the memory address
+             next_load_tx_phase = true; // Move to second phase next time
          }
      }
  
-     if (in_load_tx2) {
-         next_tx_shift_register = in_data_in;
-         tx_buf_tail = (tx_buf_tail + 1) % TX_BUFFER_SIZE;
-         load_tx_phase = false; // Reset phase for next load operation
+     // Hold the read address on the tail until load_tx2 takes the data,
+     // so the memory latency is covered in either loop timing mode
+     if (in_load_tx || load_tx_phase) {
+         out_addr = TX_BUFFER_START + tx_buf_tail.range(TX_FIFO_DEPTH_LOG2 - 1, 0);
+     }
+ 
+     if (in_load_tx2 && load_tx_phase) {
+         next_tx_holding_register = in_data_in;
+         next_tx_holding_valid = true;
+         next_tx_buf_tail = tx_buf_tail + 1;
+         next_load_tx_phase = false; // Reset phase for next load operation
+     }
+      
+     // The frame has left the line. A back-to-back start on the same
+     // tick marks the next one valid again below.
+     if (in_tx_end) {
+         next_tx_frame_valid = false;
      }
       
      if (in_tx_start) {
-         // Send start bit (always 0)
-         next_tx_out = false;
+         // Send start bit (always 0) only when there is something to
+         // send; otherwise the line stays at mark for the whole frame
+         // slot rather than shifting out a stale byte
+         next_tx_frame_valid = next_tx_flow_char != 0 || next_slip_tx_escape != 0 ||
+                               next_slip_tx_end || tx_holding_valid;
+         next_tx_out = !next_tx_frame_valid;
+         
+         // XON/XOFF jumps ahead of everything queued, even into the
+         // middle of a SLIP escape; the far end strips it before its
+         // de-framer sees the stream.
+         if (next_tx_flow_char != 0) {
+             next_tx_shift_register = next_tx_flow_char;
+             next_tx_addr_bit = false;
+             next_tx_parity_bit = calculate_parity(next_tx_flow_char, tx_data_bits, tx_parity_even);
+             next_tx_flow_char = 0;
+         }
+         // SLIP framing stage between the holding register and the
+         // shift register. The second half of an escape, then a frame
+         // END, go out before the next byte is taken from the ring.
+         else if (next_slip_tx_escape != 0 || next_slip_tx_end) {
+             sc_uint<8> code = (next_slip_tx_escape != 0) ? next_slip_tx_escape : (sc_uint<8>)SLIP_END;
+             
+             if (next_slip_tx_escape != 0) {
+                 next_slip_tx_escape = 0;
+             } else {
+                 next_slip_tx_end = false;
+             }
+             
+             next_tx_shift_register = code;
+             next_tx_addr_bit = false;
+             next_tx_parity_bit = calculate_parity(code, tx_data_bits, tx_parity_even);
+         } else if (tx_holding_valid) {
+             // Move the held byte into the shift register
+             next_tx_holding_valid = false;
+             
+             // Bit 8 of a THR write marks an address byte, or with SLIP
+             // framing the last byte of a packet
+             next_tx_addr_bit = tx_holding_register[8];
+             
+             // Parity and CRC see the frame's data bits only, the CRC
+             // covers the payload before any escaping
+             sc_uint<8> byte = tx_holding_register.range(7, 0).to_uint();
+             byte &= (1 << tx_data_bits) - 1;
+             next_tx_crc_reg = crc_update(next_tx_crc_reg, byte, tx_crc_mode);
+             
+             if (tx_framing == FRAMING_SLIP) {
+                 next_slip_tx_end = tx_holding_register[8] == 1;
+                 next_tx_addr_bit = false;
+                 
+                 next_slip_tx_escape = slip_escape(byte);
+                 if (next_slip_tx_escape != 0) {
+                     byte = SLIP_ESC;
+                 }
+             }
+             
+             next_tx_shift_register = byte;
+             next_tx_parity_bit = calculate_parity(byte, tx_data_bits, tx_parity_even);
+         }
      }
       
-     if (in_tx_data) {
+     if (in_tx_data && tx_frame_valid) {
          // Send data bits (LSB first)
          next_tx_out = tx_shift_register[0];    // tx_out is a TX pin
          next_tx_shift_register = tx_shift_register >> 1;
      }
       
-     if (in_tx_parity && parity_enabled) {
-         // Send parity bit if enabled
-         next_tx_out = calculate_parity(tx_shift_register);
+     if (in_tx_parity && !tx_frame_valid) {
+         // Empty frame slot, hold mark
+     } else if (in_tx_parity && tx_multidrop) {
+         // Send the address bit in place of parity
+         next_tx_out = tx_addr_bit;
+     } else if (in_tx_parity && tx_parity_enabled) {
+         // Send parity bit if enabled, computed when the frame started
+         next_tx_out = tx_parity_bit;
      }
       
      if (in_tx_stop) {
@@ -279,23 +954,49 @@
      next_tx_buffer_full = tx_buffer_check();
  }
  
- // RX compute method
- void datapath::compute_rx() {
-     // Initialize next-state values to current values
+ // Next-state values for this iteration, starting from the current state
+ void datapath::hold_rx_state() {
      next_rx_buffer_empty = out_rx_buffer_empty;
      next_parity_error = out_parity_error;
      next_framing_error = out_framing_error;
      next_overrun_error = out_overrun_error;
      next_rx_shift_register = rx_shift_register;
      next_rx_buf_head = rx_buf_head;
-     next_rx_buf_tail = rx_buf_tail;
-     next_data_out = out_data_out;
-     
+     next_rx_buf_tail = in_rx_tail;  // Host pops through the data port
+     next_rx_frame_tags = rx_frame_tags;
+     next_rx_frame_zero = rx_frame_zero;
+     next_rx_frame_stamp = rx_frame_stamp;
+     next_rx_addr_bit = rx_addr_bit;
+     next_rx_addressed = rx_addressed;
+     next_rx_peer_xoff = rx_peer_xoff;
+     next_rx_break_hold = rx_break_hold;
+     next_rx_sampling = rx_sampling;
+     next_slip_rx_escape = slip_rx_escape;
+     next_slip_rx_staged = slip_rx_staged;
+     next_slip_rx_stage = slip_rx_stage;
+     next_slip_rx_stage_stamp = slip_rx_stage_stamp;
+     next_match_valid = match_valid;
+     next_match_ring_index = match_ring_index;
+     next_rx_crc_reg = rx_crc_reg;
+ }
+ 
+ // RX compute method
+ void datapath::compute_rx() {
      // Handle RX operations based on control signals
      if (in_rx_start) {
+         next_rx_frame_tags = 0;
+         next_rx_frame_zero = true;
+         next_rx_frame_stamp = rx_edge_stamp;
+         
+         // A new frame clears the previous frame's line status
+         next_parity_error = false;
+         next_framing_error = false;
+         next_overrun_error = false;
+         
          // Verify start bit is 0
-         if (in_rx_in != 0) {
+         if (rx_bit_value != 0) {
              next_framing_error = true;
+             next_rx_frame_tags[RX_TAG_FRAMING - 8] = 1;
          }
      }
       
@@ -303,149 +1004,313 @@
          // Receive data bit - shift from MSB down to match the transmission order (LSB first)
          next_rx_shift_register = (rx_shift_register >> 1);
          // Place new bit in MSB position
-         next_rx_shift_register[DATA_W-1] = in_rx_in;
+         next_rx_shift_register[DATA_W-1] = rx_bit_value;
+         
+         if (rx_bit_value) {
+             next_rx_frame_zero = false;
+         }
      }
       
-     if (in_rx_parity && parity_enabled) {
+     if (in_rx_parity && rx_bit_value) {
+         next_rx_frame_zero = false;
+     }
+     
+     if (in_rx_parity && multidrop) {
+         // Address bit in place of parity
+         next_rx_addr_bit = rx_bit_value;
+     } else if (in_rx_parity && parity_enabled) {
          // Check parity if enabled
-         bool expected_parity = calculate_parity(rx_shift_register);
-         if (in_rx_in != expected_parity) {
+         bool expected_parity = calculate_parity(rx_received_byte(), data_bits, parity_even);
+         if (rx_bit_value != expected_parity) {
              next_parity_error = true;
+             next_rx_frame_tags[RX_TAG_PARITY - 8] = 1;
          }
      }
       
      if (in_rx_stop) {
          // Verify stop bit is 1
-         if (in_rx_in != 1) {
+         if (rx_bit_value != 1) {
              next_framing_error = true;
+             next_rx_frame_tags[RX_TAG_FRAMING - 8] = 1;
+             
+             // Line low for the whole frame: a break, not a character.
+             // One zero byte tagged as a break goes in the ring and the
+             // receiver waits for mark before the next start bit.
+             if (next_rx_frame_zero) {
+                 next_rx_frame_tags[RX_TAG_BREAK - 8] = 1;
+                 next_rx_break_hold = true;
+                 next_rx_sampling = false;
+             }
+         }
+         
+         sc_uint<8> masked_data = rx_received_byte();
+         
+         // Multidrop: an address frame selects or deselects this
+         // station and is not stored. Data frames for another station
+         // are dropped here, so they never take a ring slot or wake
+         // the host. A break is a line condition and always goes in.
+         bool store = true;
+         if (multidrop && next_rx_frame_tags[RX_TAG_BREAK - 8] == 0) {
+             if (rx_addr_bit) {
+                 sc_uint<8> address = masked_data;
+                 next_rx_addressed = ((address ^ station_addr) & station_mask) == 0;
+                 store = false;
+             } else {
+                 store = rx_addressed;
+             }
+         }
+         
+         // In-band flow control: an intact XON/XOFF sets the peer's
+         // request for our transmitter and never enters the ring
+         if (store && (modem_control & MCR_XON_XOFF) != 0 && next_rx_frame_tags == 0 &&
+             is_flow_char(masked_data)) {
+             next_rx_peer_xoff = (masked_data == XOFF_CHAR);
+             store = false;
          }
-         // Check for buffer overrun before storing
-         else if (((rx_buf_head + 1) % RX_BUFFER_SIZE) == rx_buf_tail) {
+         
+         sc_uint<RX_ENTRY_W> entry = masked_data;
+         entry.range(RX_ENTRY_W - 1, 8) = next_rx_frame_tags;
+         sc_uint<32> stamp = rx_frame_stamp;
+         
+         // SLIP de-framer. END and ESC are consumed and each decoded
+         // byte is held back until the next character, see slip_decode()
+         if (store && rx_framing == FRAMING_SLIP) {
+             store = slip_decode(masked_data, next_rx_frame_tags, rx_frame_stamp,
+                                 next_slip_rx_escape, next_slip_rx_staged,
+                                 next_slip_rx_stage, next_slip_rx_stage_stamp, entry, stamp);
+         }
+         
+         if (!store) {
+             // Not for this station, flow control, or held by the de-framer
+         } else if ((rx_buf_head ^ next_rx_buf_tail) == RX_BUFFER_SIZE) {
              // Buffer full → flag overrun, don't store new byte
              next_overrun_error = true;
          }
-         else if (!next_framing_error && !(parity_enabled && next_parity_error)) {
-             // Only store data if no errors
+         else {
+             // Bad bytes are stored too, tagged with this frame's
+             // errors, so the host can drain and filter in one pass
              
              // Get the address for the RX buffer in Memory
-             unsigned int mem_addr = RX_BUFFER_START + rx_buf_head;
+             unsigned int mem_addr = RX_BUFFER_START + rx_buf_head.range(RX_FIFO_DEPTH_LOG2 - 1, 0);
              
-             // Apply mask based on data_bits (if less than 8)
-             sc_bv<8> masked_data = rx_shift_register;
-             if (data_bits < 8) {
-                 sc_bv<8> mask = (1 << data_bits) - 1;
-                 masked_data &= mask;
-             }
-             
-             // Set up data and address for writing to Memory
-             out_addr = mem_addr;
-             next_data_out = masked_data;  // This will be written to Memory
-             
-             // Signal to memory_map that we want to write to this address
+             // Store through the write port, addr stays on the TX fetch
              out_dp_write_enable = true;
              out_dp_addr = mem_addr;
-             out_dp_data_in = masked_data;
+             out_dp_data_in = entry;
+             out_dp_ts_data = stamp;
+             
+             // Every byte that enters the ring goes into the RX CRC
+             next_rx_crc_reg = crc_update(next_rx_crc_reg, entry.range(7, 0), rx_crc_mode);
+             
+             // Latch the slot of the newest match character
+             if (match_char[8] && entry.range(7, 0) == match_char.range(7, 0)) {
+                 next_match_valid = true;
+                 next_match_ring_index = rx_buf_head;
+             }
              
              // Update head pointer
-             next_rx_buf_head = (rx_buf_head + 1) % RX_BUFFER_SIZE;
+             next_rx_buf_head = rx_buf_head + 1;
          }
      }
      
-     // CPU/host is reading from RX buffer
-     if (in_rx_read && !out_rx_buffer_empty) {
-         // Get the address for the current tail in Memory
-         unsigned int mem_addr = RX_BUFFER_START + rx_buf_tail;
-         
-         // Read directly from Memory
-         out_addr = mem_addr;
-         next_data_out = in_data_in;  // data_in has the value from Memory
-         
-         // Update tail pointer
-         next_rx_buf_tail = (rx_buf_tail + 1) % RX_BUFFER_SIZE;
-     }
-     
      // Recompute empty flag
      next_rx_buffer_empty = (next_rx_buf_head == next_rx_buf_tail);
+     
+     // The error flags stay up until the next start bit, so the line
+     // status interrupt is seen the same way as with the fused core
+ }
  
-     if (in_error_handle) {
-         // Handle error conditions - clear error flags
-         next_parity_error = false;
-         next_framing_error = false;
-         next_overrun_error = false;
+ // Hardware flow control, TX half. CTS goes through the same two-flop
+ // synchronizer as rx_in; with auto flow on a deasserted CTS holds the
+ // transmitter at the next frame boundary, a frame already on the line
+ // always finishes.
+ void datapath::update_cts() {
+     cts_sync[1] = cts_sync[0];
+     cts_sync[0] = (bool)in_cts_in;
+     
+     bool auto_flow = (tx_modem_control & MCR_AUTO_FLOW) != 0;
+     bool xon_xoff = (tx_modem_control & MCR_XON_XOFF) != 0;
+     
+     // A received XOFF holds the transmitter like CTS does, but our own
+     // XON/XOFF always goes out so both ends cannot stall each other
+     out_cts = ((!auto_flow || cts_sync[1]) && !(xon_xoff && in_peer_xoff)) ||
+               next_tx_flow_char != 0;
+ }
+ 
+ // TX frame timestamp event. The controller pulses tx_end on the tick
+ // that ends the last stop bit of a frame, whatever the stop bit count.
+ void datapath::update_tx_timestamp() {
+     if (in_tx_end) {
+         ts_tx_toggle = !ts_tx_toggle;
      }
  }
  
- // Commit methods update actual registers based on next-state values
- void datapath::commit() {
-     // TX updates
-     out_tx_buffer_full = next_tx_buffer_full;
-     out_tx_out = next_tx_out;
-     tx_shift_register = next_tx_shift_register;
+ // In-band flow control, TX half. The RX thread raises xoff_wanted on
+ // the same RTS_THRESHOLD_REG hysteresis as auto-RTS; each change queues
+ // one XOFF or XON ahead of the TX ring. Turning the mode off drops a
+ // queued character.
+ void datapath::update_xon_xoff() {
+     queue_flow_char((tx_modem_control & MCR_XON_XOFF) != 0, in_xoff_wanted,
+                     next_tx_flow_char, next_tx_xoff_sent);
+ }
+ 
+ // Hardware flow control, RX half. Auto-RTS drops once the RX ring
+ // holds rts_threshold entries and is raised again when it has drained
+ // to half of that, so the far end sees one edge per burst rather than
+ // one per byte.
+ void datapath::update_rts() {
+     bool auto_flow = (modem_control & MCR_AUTO_FLOW) != 0;
      
-     // Update TX bit counter
-     if (in_tx_data) {
-         tx_bit_count++;
-         if (tx_bit_count >= data_bits) {
-             tx_bit_count = 0;
+     // Wrap-bit pointers: the difference is the fill level
+     sc_uint<RX_PTR_W> rx_fill = next_rx_buf_head - next_rx_buf_tail;
+     
+     if (rx_fill >= rts_threshold) {
+         rts_state = false;
+     } else if (rx_fill <= (rts_threshold >> 1)) {
+         rts_state = true;
+     }
+     
+     if (auto_flow) {
+         out_rts_out = rts_state;
+     } else {
+         out_rts_out = (modem_control & MCR_RTS) != 0;
+     }
+ }
+ 
+ // RS-485 driver enable. The controller raises DE a bit period before
+ // the start bit and drops it the guard time after the last stop bit,
+ // so half-duplex turnaround needs no software in the loop.
+ void datapath::update_driver_enable() {
+     out_de_out = (tx_rs485_control & RSC_DE_ENABLE) != 0 && in_de;
+ }
+ 
+ // Character timeout. Counts sample ticks while the line is idle and
+ // the RX ring is untouched; four character times of the current frame
+ // format with bytes still waiting flags a timeout so a burst that
+ // ends below the trigger level is not stranded. Any received byte or
+ // host pop restarts the count and clears the flag.
+ void datapath::update_rx_timeout() {
+     sc_uint<RX_PTR_W> rx_fill = next_rx_buf_head - next_rx_buf_tail;
+     sc_uint<4> frame_bits = 1 + data_bits + ((parity_enabled || multidrop) ? 1 : 0) + stop_bits;
+     sc_uint<10> limit = (osr_ratio * frame_bits) << 2;
+     
+     if (rx_fill == 0 || next_rx_sampling ||
+         next_rx_buf_head != rx_buf_head || next_rx_buf_tail != rx_buf_tail) {
+         rx_timeout_count = 0;
+         out_rx_timeout = false;
+     } else if (sample_tick && !out_rx_timeout) {
+         if (rx_timeout_count >= limit - 1) {
+             out_rx_timeout = true;
+         } else {
+             rx_timeout_count++;
          }
      }
+ }
+ 
+ // Character match. compute_rx latches the ring pointer of the newest
+ // byte equal to the match character; the match stays pending until the
+ // host has popped past it, so a line-oriented driver takes one wakeup
+ // per message.
+ void datapath::update_char_match() {
+     sc_uint<RX_PTR_W> rx_fill = next_rx_buf_head - next_rx_buf_tail;
+     sc_uint<RX_PTR_W> offset = next_match_ring_index - next_rx_buf_tail;
      
-     // Reset bit counter when loading new data
-     if (in_load_tx) {
-         tx_bit_count = 0;
+     if (!next_match_valid || offset >= rx_fill) {
+         next_match_valid = false;
      }
      
+     out_match_pending = next_match_valid;
+ }
+ 
+ // Interrupt generation. Sources are levels, the IRQ stays up until the
+ // condition behind it goes away. Trigger levels and priorities are
+ // shared with the fused core through interrupt_id().
+ void datapath::update_interrupts() {
+     sc_uint<RX_PTR_W> rx_fill = next_rx_buf_head - next_rx_buf_tail;
+     sc_uint<TX_PTR_W> tx_fill = in_tx_fill;  // From the TX thread
+     
+     bool line_status = next_parity_error || next_framing_error || next_overrun_error;
+     
+     out_int_id = interrupt_id(int_enable, fifo_control, line_status, out_match_pending,
+                               out_rx_timeout, rx_fill, tx_fill);
+     out_irq = (out_int_id != IIR_NONE);
+ }
+ 
+ // Commit methods update actual registers based on next-state values
+ void datapath::commit_tx() {
+     // TX updates
+     out_tx_buffer_full = next_tx_buffer_full;
+     tx_line = next_tx_out;
+     
+     // Break holds the line low over whatever the transmitter is doing;
+     // the frame logic keeps running so clearing the bit resumes cleanly
+     out_tx_out = next_tx_out && !break_control;
+     tx_shift_register = next_tx_shift_register;
+     tx_buf_tail = next_tx_buf_tail;
+     load_tx_phase = next_load_tx_phase;
+     tx_holding_register = next_tx_holding_register;
+     tx_holding_valid = next_tx_holding_valid;
+     tx_frame_valid = next_tx_frame_valid;
+     tx_addr_bit = next_tx_addr_bit;
+     tx_parity_bit = next_tx_parity_bit;
+     tx_flow_char = next_tx_flow_char;
+     tx_xoff_sent = next_tx_xoff_sent;
+     slip_tx_escape = next_slip_tx_escape;
+     slip_tx_end = next_slip_tx_end;
+     tx_crc_reg = next_tx_crc_reg;
+     
+     // A flow character, pending escape or END needs a frame of its own
+     out_tx_ready = tx_holding_valid || tx_flow_char != 0 ||
+                    slip_tx_escape != 0 || slip_tx_end;
+ }
+ 
+ void datapath::commit_rx() {
      // RX updates
      out_rx_buffer_empty = next_rx_buffer_empty;
      out_parity_error = next_parity_error;
      out_framing_error = next_framing_error;
      out_overrun_error = next_overrun_error;
      rx_shift_register = next_rx_shift_register;
+     rx_frame_tags = next_rx_frame_tags;
+     rx_frame_zero = next_rx_frame_zero;
      rx_buf_head = next_rx_buf_head;
      rx_buf_tail = next_rx_buf_tail;
-     out_data_out = next_data_out;
-     
-     // Update RX bit counter
-     if (in_rx_data) {
-         rx_bit_count++;
-     }
-     
-     if (in_rx_start) {
-         rx_bit_count = 0;
-     }
+     rx_frame_stamp = next_rx_frame_stamp;
+     rx_addr_bit = next_rx_addr_bit;
+     rx_addressed = next_rx_addressed;
+     rx_peer_xoff = next_rx_peer_xoff;
+     rx_break_hold = next_rx_break_hold;
+     rx_sampling = next_rx_sampling;
+     slip_rx_escape = next_slip_rx_escape;
+     slip_rx_staged = next_slip_rx_staged;
+     slip_rx_stage = next_slip_rx_stage;
+     slip_rx_stage_stamp = next_slip_rx_stage_stamp;
+     match_valid = next_match_valid;
+     match_ring_index = next_match_ring_index;
+     rx_crc_reg = next_rx_crc_reg;
  }
  
  // Helper methods
- bool datapath::calculate_parity(sc_bv<8> data) {
-     int count = 0;
+ 
+ // Parity bit for the low `bits` bits of data, one XOR reduction.
+ // Even parity sends a 1 when the data has an odd number of ones.
+ bool datapath::calculate_parity(sc_uint<8> data, sc_uint<4> bits, bool even) {
+     sc_uint<8> mask = (1 << bits) - 1;
+     sc_uint<8> masked = data & mask;
+     bool odd = masked.xor_reduce();
      
-     // Count the number of '1' bits
-     for (int i = 0; i < 8; i++) {
-         if (data[i] == '1') {
-             count++;
-         }
-     }
+     return even ? odd : !odd;
+ }
+ 
+ // Received data bits, right-aligned. Bits shift in at the MSB, so after
+ // data_bits of them the first one sits data_bits below the top.
+ sc_uint<8> datapath::rx_received_byte() {
+     sc_uint<DATA_W> shifted = rx_shift_register.to_uint() >> (DATA_W - data_bits);
      
-     // For even parity: return true if count is odd (need to add a 1)
-     // For odd parity: return true if count is even (need to add a 1)
-     if (parity_even) {
-         return (count % 2 != 0);  // Even parity
-     } else {
-         return (count % 2 == 0);  // Odd parity
-     }
+     return shifted.range(7, 0);
  }
  
  bool datapath::tx_buffer_check() {
-     // Check if TX buffer is full
-     return ((tx_buf_head + 1) % TX_BUFFER_SIZE) == tx_buf_tail;
- }
- 
- // New method to provide configuration to controller 
- void datapath::sync_controller_config() {
-     // This is already done in update_configuration
-     // Just making sure all the controller config signals are updated
-     out_ctrl_parity_enabled = parity_enabled;
-     out_ctrl_parity_even = parity_even;
-     out_ctrl_data_bits = data_bits;
-     out_ctrl_stop_bits = stop_bits;
- }
\ No newline at end of file
+     // Check if TX buffer is full - indices equal, wrap bits differ
+     return (tx_buf_head ^ tx_buf_tail) == TX_BUFFER_SIZE;
+ }
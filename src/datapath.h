@@ -12,6 +12,7 @@
  #include "systemc.h"
  #include "stratus_hls.h"
  #include "sizes.h"
+ #include "uart_common.h"
  
  SC_MODULE(datapath) {
      // Clock and reset
@@ -29,102 +30,299 @@
      sc_in<bool> rx_data;              // Port 9
      sc_in<bool> rx_parity;            // Port 10
      sc_in<bool> rx_stop;              // Port 11
-     sc_in<bool> error_handle;         // Port 12
-     sc_in<bool> rx_read;              // Port 13
+     sc_in<bool> de;                   // Port 12 - Transmitter owns the bus
+     sc_in<bool> tx_end;               // Port 13 - Last stop bit of a frame is over
      
      // Status signals (outputs to controller)
      sc_out<bool> tx_buffer_full;      // Port 14
-     sc_out<bool> rx_buffer_empty;     // Port 15
-     sc_out<bool> parity_error;        // Port 16
-     sc_out<bool> framing_error;       // Port 17
-     sc_out<bool> overrun_error;       // Port 18
+     sc_out<bool> tx_buffer_empty;     // Port 15 - TX ring holds no bytes
+     sc_out<bool> rx_buffer_empty;     // Port 16
+     sc_out<bool> parity_error;        // Port 17
+     sc_out<bool> framing_error;       // Port 18
+     sc_out<bool> overrun_error;       // Port 19
+     sc_out<bool> tx_ready;            // Port 20 - TX holding register loaded
+     sc_out<bool> tx_tick;             // Port 21 - One pulse per TX bit period
+     sc_out<bool> rx_tick;             // Port 22 - RX mid-bit sample ready
+     sc_out<bool> rx_bit;              // Port 23 - Majority-voted RX bit
+     sc_out<bool> cts;                 // Port 24 - Clear to start a frame
+     sc_out<bool> rx_timeout;          // Port 25 - Character timeout pending
+     sc_out<bool> irq;                 // Port 26 - Interrupt request
+     sc_out<sc_uint<4>> int_id;        // Port 27 - Interrupt identification code
+     sc_out<bool> match_pending;       // Port 28 - Matched byte still in the RX ring
+     sc_out<sc_uint<RX_PTR_W>> match_index; // Port 29 - RX ring pointer of the matched byte
+     sc_out<bool> ts_tx_event;         // Port 30 - Toggles on each TX stop bit end
+     sc_out<bool> tx_idle;             // Port 31 - No frame on the line or waiting to start
      
      // Configuration outputs to controller
-     sc_out<bool> ctrl_parity_enabled; // Port 19
-     sc_out<bool> ctrl_parity_even;    // Port 20
-     sc_out<sc_uint<3>> ctrl_data_bits;// Port 21
-     sc_out<sc_uint<2>> ctrl_stop_bits;// Port 22
+     sc_out<bool> ctrl_parity_enabled; // Port 32
+     sc_out<bool> ctrl_parity_even;    // Port 33
+     sc_out<sc_uint<4>> ctrl_data_bits;// Port 34
+     sc_out<sc_uint<2>> ctrl_stop_bits;// Port 35
+     sc_out<sc_uint<4>> ctrl_de_guard; // Port 36
      
      // External interface
-     sc_in<bool> rx_in;                // Port 23 - Serial input
-     sc_out<bool> tx_out;              // Port 24 - Serial output
-     sc_in<sc_bv<DATA_W>> data_in;     // Port 25 - Data input from memory map
-     sc_out<sc_bv<DATA_W>> data_out;   // Port 26 - Data output to memory map
-     sc_out<sc_bv<ADDR_W>> addr;       // Port 27 - Address to memory map
+     sc_in<bool> rx_in;                // Port 37 - Serial input
+     sc_out<bool> tx_out;              // Port 38 - Serial output
+     sc_in<bool> cts_in;               // Port 39 - Clear to send (high = send)
+     sc_out<bool> rts_out;             // Port 40 - Request to send (high = ready)
+     sc_out<bool> de_out;              // Port 41 - RS-485 driver enable
+     sc_in<sc_uint<DATA_W>> data_in;   // Port 42 - Data input from memory map
+     sc_out<sc_uint<ADDR_W>> addr;     // Port 43 - TX ring fetch address
      
      // Interface to memory map for direct writes
-     sc_out<sc_bv<DATA_W>> dp_data_in;      // Port 28 - Data to write to memory
-     sc_out<sc_bv<ADDR_W>> dp_addr;         // Port 29 - Address to write to
-     sc_out<bool> dp_write_enable;          // Port 30 - Write enable signal
+     sc_out<sc_uint<RX_ENTRY_W>> dp_data_in; // Port 44 - Data to write to memory
+     sc_out<sc_uint<ADDR_W>> dp_addr;        // Port 45 - Address to write to
+     sc_out<bool> dp_write_enable;          // Port 46 - Write enable signal
+     sc_out<sc_uint<32>> dp_ts_data;        // Port 47 - Start-bit stamp of the stored entry
+     sc_in<sc_uint<32>> ts_count;           // Port 48 - Memory map timestamp counter
+     
+     // Frame check values to the memory map
+     sc_out<sc_uint<32>> tx_crc;            // Port 49 - CRC of the bytes sent
+     sc_out<sc_uint<32>> rx_crc;            // Port 50 - CRC of the bytes stored
+     
+     // Configuration shadows from the memory map
+     sc_in<sc_uint<DATA_W>> cfg_line_control; // Port 51 - Line control register
+     sc_in<sc_uint<16>> cfg_baud_divisor;    // Port 52 - Baud divisor, high:low
+     sc_in<sc_uint<8>> cfg_baud_fraction;    // Port 53 - Baud divisor fraction
+     sc_in<sc_uint<DATA_W>> cfg_fifo_control; // Port 54 - FIFO control register
+     sc_in<sc_uint<DATA_W>> cfg_rx_control;  // Port 55 - Receiver control register
+     sc_in<sc_uint<DATA_W>> cfg_modem_control; // Port 56 - Modem control register
+     sc_in<sc_uint<DATA_W>> cfg_rts_threshold; // Port 57 - Auto-RTS threshold
+     sc_in<sc_uint<DATA_W>> cfg_int_enable;  // Port 58 - Interrupt enable register
+     sc_in<sc_uint<16>> cfg_station;         // Port 59 - Station mask:address
+     sc_in<sc_uint<DATA_W>> cfg_rs485_control; // Port 60 - RS-485 control register
+     sc_in<sc_uint<DATA_W>> cfg_crc_control; // Port 61 - CRC mode and clear toggles
+     sc_in<sc_uint<DATA_W>> cfg_framing_control; // Port 62 - Byte-stuffing framer modes
+     sc_in<sc_uint<DATA_W>> cfg_match_char;  // Port 63 - Match character and enable
+     
+     // Ring pointers shared with the memory map
+     sc_in<sc_uint<TX_PTR_W>> tx_head;      // Port 64 - Host TX write pointer
+     sc_in<sc_uint<RX_PTR_W>> rx_tail;      // Port 65 - Host RX read pointer
+     sc_out<sc_uint<TX_PTR_W>> tx_tail;     // Port 66 - TX read pointer
+     sc_out<sc_uint<RX_PTR_W>> rx_head;     // Port 67 - RX write pointer
      
      // Memory management inputs
-     sc_in<bool> start;                // Port 31 - Start signal
-     sc_in<bool> mem_we;               // Port 32 - Memory write enable
+     sc_in<bool> start;                // Port 68 - Start signal
+     sc_in<bool> mem_we;               // Port 69 - Memory write enable
      
-     // Main process method
-     void process();
+     // Thread bodies, one per direction
+     void tx_process();
+     void rx_process();
      
-     // Core methods
-     void reset();
-     void read_inputs();
-     void write_outputs();
-     void compute();
-     void commit();
+     // Core methods, split by thread
+     void reset_tx();
+     void reset_rx();
+     void read_tx_inputs();
+     void read_rx_inputs();
+     void write_tx_outputs();
+     void write_rx_outputs();
+     void tx_compute();
+     void rx_compute();
+     void commit_tx();
+     void commit_rx();
+     void hold_tx_state();
+     void hold_rx_state();
      
-     // Processing methods
+     // TX thread processing methods
+     void update_tx_configuration();
+     void update_baud_tick();
+     void update_xon_xoff();
+     void update_cts();
+     void update_tx_timestamp();
+     void update_driver_enable();
+     
+     // RX thread processing methods
      void update_configuration();
+     void update_sample_tick();
+     void update_rx_sampler();
+     void update_autobaud();
+     void update_rts();
+     void update_rx_timeout();
+     void update_char_match();
+     void update_interrupts();
      void compute_tx();
      void compute_rx();
-     void sync_controller_config();
      
      // Helper methods
-     bool calculate_parity(sc_bv<8> data);
+     bool calculate_parity(sc_uint<8> data, sc_uint<4> bits, bool even);
+     sc_uint<8> rx_received_byte();
+     bool baud_divide(sc_uint<16>& counter, sc_uint<8>& frac_acc,
+                      sc_uint<16> divider, sc_uint<8> fraction);
      bool tx_buffer_check();
      
      // Internal registers
+     sc_bv<DATA_W> tx_holding_register;// Transmit holding register
+     bool tx_holding_valid;            // Holding register has a byte
      sc_bv<DATA_W> tx_shift_register;  // Transmit shift register
      sc_bv<DATA_W> rx_shift_register;  // Receive shift register
+     sc_uint<3> rx_frame_tags;         // Error tags for the frame in progress
+     bool rx_frame_zero;               // Every bit of the frame so far was 0
+     bool rx_break_hold;               // Break seen, waiting for mark
+     bool rx_addr_bit;                 // 9th bit of the frame (multidrop)
+     bool rx_addressed;                // Last address frame matched (multidrop)
+     bool tx_addr_bit;                 // 9th bit to send (multidrop)
+     bool tx_parity_bit;               // Parity of the byte being sent
+     bool tx_frame_valid;              // tx_start found a byte, the frame is on the line until tx_end
+     
+     // Byte-stuffing framers
+     sc_uint<2> tx_framing;            // TX framing mode
+     sc_uint<8> slip_tx_escape;        // Second half of an escape still to send, 0 if none
+     bool slip_tx_end;                 // END still to send after the last byte
+     sc_uint<2> rx_framing;            // RX framing mode
+     bool slip_rx_escape;              // ESC received, next byte is escaped
+     bool slip_rx_staged;              // slip_rx_stage holds a decoded byte
+     sc_uint<RX_ENTRY_W> slip_rx_stage;// Decoded byte waiting to see if it ends the frame
+     sc_uint<32> slip_rx_stage_stamp;  // Start-bit stamp of slip_rx_stage
+     bool tx_line;                     // Line level from the frame logic
      
      // Buffer pointers
-     unsigned int tx_buf_head;    // Head pointer for TX buffer in memory
-     unsigned int tx_buf_tail;    // Tail pointer for TX buffer in memory
-     unsigned int rx_buf_head;    // Head pointer for RX buffer in memory
-     unsigned int rx_buf_tail;    // Tail pointer for RX buffer in memory
+     sc_uint<TX_PTR_W> tx_buf_head;    // Head pointer for TX buffer (host owned)
+     sc_uint<TX_PTR_W> tx_buf_tail;    // Tail pointer for TX buffer in memory
+     sc_uint<RX_PTR_W> rx_buf_head;    // Head pointer for RX buffer in memory
+     sc_uint<RX_PTR_W> rx_buf_tail;    // Tail pointer for RX buffer (host owned)
      
      // Bit counters
-     unsigned int tx_bit_count;   // Counter for TX bits
-     unsigned int rx_bit_count;   // Counter for RX bits
      
      // Baud rate generation
      sc_uint<16> baud_divider;    // Baud rate divisor value
+     sc_uint<8> baud_fraction;    // Fractional divisor in 1/256 steps
      sc_uint<16> baud_counter;    // Counter for baud rate generation
+     sc_uint<8> baud_frac_acc;    // Fraction accumulator
+     bool sample_tick;            // Oversampling tick this cycle
+     sc_uint<5> osr_ratio;        // Samples per bit (16, 8 or 4)
+     sc_uint<4> tx_os_count;      // Divider periods into the current TX bit
+     
+     // Oversampling receiver front-end
+     sc_uint<2> rx_sync;          // Input synchronizer
+     sc_uint<3> rx_samples;       // Last three samples of rx_in
+     bool rx_sampling;            // Inside a frame
+     sc_uint<4> rx_os_count;      // Sample ticks since the bit edge
+     sc_uint<4> rx_frame_bits;    // Bits delivered in this frame
+     bool rx_bit_value;           // Voted value of the last bit
+     
+     // Automatic baud-rate detection
+     sc_uint<DATA_W> rx_control;  // Receiver control register copy
+     sc_uint<3> autobaud_state;   // Detector state
+     sc_uint<24> autobaud_count;  // Iterations since the start edge
+     sc_uint<3> autobaud_edges;   // Falling edges seen after the start
+     bool autobaud_prev;          // Line level last cycle
+     sc_uint<2> autobaud_step;    // Register write-back step
+     sc_uint<16> autobaud_divisor;// Measured divisor
+     sc_uint<8> autobaud_fraction;// Measured divisor fraction
+     
+     // Hardware flow control
+     sc_uint<DATA_W> modem_control;// Modem control register copy
+     sc_uint<DATA_W> rts_threshold;// RX fill level that drops auto-RTS
+     sc_uint<2> cts_sync;         // CTS synchronizer
+     bool rts_state;              // Auto-RTS level with hysteresis
+     bool rx_peer_xoff;           // Last in-band flow character received was XOFF
+     
+     // Interrupt logic
+     sc_uint<DATA_W> fifo_control;// FIFO control register copy
+     sc_uint<DATA_W> int_enable;  // Interrupt enable register copy
+     sc_uint<10> rx_timeout_count;// Idle sample ticks with data waiting
+     
+     // Character match
+     sc_uint<DATA_W> match_char;  // Match register copy, bit 8 enables
+     bool match_valid;            // match_ring_index holds a match
+     sc_uint<RX_PTR_W> match_ring_index;// RX ring pointer of the last match
+     
+     // Frame check engine, one running CRC per direction
+     sc_uint<32> tx_crc_reg;      // CRC over the bytes sent
+     sc_uint<2> tx_crc_mode;      // TX thread's copy of the CRC mode
+     bool tx_crc_clear;           // Last TX clear toggle seen
+     sc_uint<32> rx_crc_reg;      // CRC over the bytes stored in the RX ring
+     sc_uint<2> rx_crc_mode;      // RX thread's copy of the CRC mode
+     bool rx_crc_clear;           // Last RX clear toggle seen
      
      // Configuration registers
      bool parity_enabled;         // Parity enabled flag
      bool parity_even;            // Even parity (1) or odd parity (0)
-     sc_uint<3> data_bits;        // Number of data bits (5-8)
+     sc_uint<4> data_bits;        // Number of data bits (5-8)
      sc_uint<2> stop_bits;        // Number of stop bits (1, 1.5, 2)
+     bool break_control;          // Force tx_out low (LCR break)
+     bool multidrop;              // 9-bit mode, parity slot carries the address bit
+     sc_uint<8> station_addr;     // Multidrop station address
+     sc_uint<8> station_mask;     // Multidrop address compare mask
+     sc_uint<DATA_W> rs485_control;// RS-485 control register copy
      
      // Internal state variables
-     bool load_tx_phase;          // State variable for load_tx two-phase operation
+     bool load_tx_phase;          // Ring read issued, waiting for load_tx2
+     
+     // TX thread copies of the configuration, so the two threads
+     // share no registers
+     bool tx_parity_enabled;      // Parity enabled flag
+     bool tx_parity_even;         // Even parity (1) or odd parity (0)
+     sc_uint<4> tx_data_bits;     // Number of data bits (5-8)
+     bool tx_multidrop;           // Parity slot carries the address bit
+     sc_uint<16> tx_baud_divider; // Baud rate divisor value
+     sc_uint<8> tx_baud_fraction; // Fractional divisor in 1/256 steps
+     sc_uint<16> tx_baud_counter; // TX baud divider count
+     sc_uint<8> tx_baud_frac_acc; // TX fraction accumulator
+     sc_uint<5> tx_osr_ratio;     // Divider periods per TX bit
+     sc_uint<DATA_W> tx_modem_control;// Modem control register copy
+     sc_uint<DATA_W> tx_rs485_control;// RS-485 control register copy
+     sc_uint<8> tx_flow_char;     // XON/XOFF waiting to go out, 0 if none
+     bool tx_xoff_sent;           // Last flow character sent was XOFF
+     
+     // Frame timestamps for the memory map
+     bool ts_tx_toggle;           // ts_tx_event level
+     sc_uint<32> rx_edge_stamp;   // ts_count at the last start edge (RX thread)
+     sc_uint<32> rx_frame_stamp;  // Start-bit stamp of the frame being received
+     
+     // TX ring fill level, from the TX thread to the RX thread's
+     // interrupt logic
+     sc_signal<sc_uint<TX_PTR_W>> tx_fill_level;
+     
+     // In-band flow control, from the RX thread to the TX thread: the
+     // level our XON/XOFF should announce, and the peer's last request
+     sc_signal<bool> xoff_wanted;
+     sc_signal<bool> peer_xoff;
      
      // Internal input values
-     sc_bit in_start;
-     sc_bit in_mem_we;
      sc_bit in_load_tx;
      sc_bit in_load_tx2;
      sc_bit in_tx_start;
      sc_bit in_tx_data;
      sc_bit in_tx_parity;
      sc_bit in_tx_stop;
+     sc_bit in_tx_end;
      sc_bit in_rx_start;
      sc_bit in_rx_data;
      sc_bit in_rx_parity;
      sc_bit in_rx_stop;
-     sc_bit in_error_handle;
-     sc_bit in_rx_read;
      sc_bit in_rx_in;
+     sc_bit in_cts_in;
+     sc_bit in_de;
+     sc_bit in_rx_de;                  // RX thread's copy of de
+     sc_uint<32> in_ts_count;
+     sc_uint<TX_PTR_W> in_tx_fill;
+     sc_bit in_xoff_wanted;
+     sc_bit in_peer_xoff;
      sc_bv<DATA_W> in_data_in;
+     sc_uint<TX_PTR_W> in_tx_head;
+     sc_uint<RX_PTR_W> in_rx_tail;
+     sc_uint<DATA_W> in_tx_cfg_line_control;   // TX thread's copies of the shadows
+     sc_uint<16> in_tx_cfg_baud_divisor;
+     sc_uint<8> in_tx_cfg_baud_fraction;
+     sc_uint<DATA_W> in_tx_cfg_rx_control;
+     sc_uint<DATA_W> in_tx_cfg_modem_control;
+     sc_uint<DATA_W> in_tx_cfg_rs485_control;
+     sc_uint<DATA_W> in_tx_cfg_crc_control;
+     sc_uint<DATA_W> in_tx_cfg_framing_control;
+     sc_uint<DATA_W> in_cfg_line_control;
+     sc_uint<16> in_cfg_baud_divisor;
+     sc_uint<8> in_cfg_baud_fraction;
+     sc_uint<DATA_W> in_cfg_fifo_control;
+     sc_uint<DATA_W> in_cfg_rx_control;
+     sc_uint<DATA_W> in_cfg_modem_control;
+     sc_uint<DATA_W> in_cfg_rts_threshold;
+     sc_uint<DATA_W> in_cfg_int_enable;
+     sc_uint<16> in_cfg_station;
+     sc_uint<DATA_W> in_cfg_rs485_control;
+     sc_uint<DATA_W> in_cfg_crc_control;
+     sc_uint<DATA_W> in_cfg_framing_control;
+     sc_uint<DATA_W> in_cfg_match_char;
      
      // Internal output values
      sc_bit out_tx_buffer_full;
@@ -132,33 +330,75 @@
      sc_bit out_parity_error;
      sc_bit out_framing_error;
      sc_bit out_overrun_error;
+     sc_bit out_tx_ready;
+     sc_bit out_tx_tick;
+     sc_bit out_rx_tick;
+     sc_bit out_rx_bit;
+     sc_bit out_cts;
+     sc_bit out_rx_timeout;
+     sc_bit out_irq;
+     sc_uint<4> out_int_id;
+     sc_bit out_match_pending;
      sc_bit out_ctrl_parity_enabled;
      sc_bit out_ctrl_parity_even;
-     sc_uint<3> out_ctrl_data_bits;
+     sc_uint<4> out_ctrl_data_bits;
      sc_uint<2> out_ctrl_stop_bits;
+     sc_uint<4> out_ctrl_de_guard;
      sc_bit out_tx_out;
-     sc_bv<DATA_W> out_data_out;
+     sc_bit out_rts_out;
+     sc_bit out_de_out;
      sc_bv<ADDR_W> out_addr;
-     sc_bv<DATA_W> out_dp_data_in;
+     sc_bv<RX_ENTRY_W> out_dp_data_in;
      sc_bv<ADDR_W> out_dp_addr;
      sc_bit out_dp_write_enable;
+     sc_uint<32> out_dp_ts_data;
      
      // Next-state values
+     bool next_load_tx_phase;
+     sc_uint<TX_PTR_W> next_tx_buf_tail;
+     sc_bv<DATA_W> next_tx_holding_register;
+     bool next_tx_holding_valid;
      bool next_tx_buffer_full;
      bool next_tx_out;
      sc_bv<DATA_W> next_tx_shift_register;
+     bool next_tx_frame_valid;
+     bool next_tx_addr_bit;
+     bool next_tx_parity_bit;
+     sc_uint<8> next_tx_flow_char;
+     bool next_tx_xoff_sent;
+     sc_uint<8> next_slip_tx_escape;
+     bool next_slip_tx_end;
+     sc_uint<32> next_tx_crc_reg;
      bool next_rx_buffer_empty;
-     unsigned int next_rx_buf_head;
-     unsigned int next_rx_buf_tail;
+     sc_uint<RX_PTR_W> next_rx_buf_head;
+     sc_uint<RX_PTR_W> next_rx_buf_tail;
      bool next_parity_error;
      bool next_framing_error;
      bool next_overrun_error;
      sc_bv<DATA_W> next_rx_shift_register;
-     sc_bv<DATA_W> next_data_out;
+     sc_uint<3> next_rx_frame_tags;
+     bool next_rx_frame_zero;
+     sc_uint<32> next_rx_frame_stamp;
+     bool next_rx_addr_bit;
+     bool next_rx_addressed;
+     bool next_rx_peer_xoff;
+     bool next_rx_break_hold;
+     bool next_rx_sampling;
+     bool next_slip_rx_escape;
+     bool next_slip_rx_staged;
+     sc_uint<RX_ENTRY_W> next_slip_rx_stage;
+     sc_uint<32> next_slip_rx_stage_stamp;
+     bool next_match_valid;
+     sc_uint<RX_PTR_W> next_match_ring_index;
+     sc_uint<32> next_rx_crc_reg;
      
      // Constructor
      SC_CTOR(datapath) {
-         SC_THREAD(process);
+         SC_THREAD(tx_process);
+         sensitive << clk.pos();
+         async_reset_signal_is(rst, false);
+         
+         SC_THREAD(rx_process);
          sensitive << clk.pos();
          async_reset_signal_is(rst, false);
      }
@@ -179,32 +419,72 @@
          ncsc_replace_name(rx_data, "rx_data");            // Port 9
          ncsc_replace_name(rx_parity, "rx_parity");        // Port 10
          ncsc_replace_name(rx_stop, "rx_stop");            // Port 11
-         ncsc_replace_name(error_handle, "error_handle");  // Port 12
-         ncsc_replace_name(rx_read, "rx_read");            // Port 13
+         ncsc_replace_name(de, "de");                      // Port 12
+         ncsc_replace_name(tx_end, "tx_end");              // Port 13
          
          ncsc_replace_name(tx_buffer_full, "tx_buffer_full");  // Port 14
-         ncsc_replace_name(rx_buffer_empty, "rx_buffer_empty");// Port 15
-         ncsc_replace_name(parity_error, "parity_error");      // Port 16
-         ncsc_replace_name(framing_error, "framing_error");    // Port 17
-         ncsc_replace_name(overrun_error, "overrun_error");    // Port 18
+         ncsc_replace_name(tx_buffer_empty, "tx_buffer_empty");// Port 15
+         ncsc_replace_name(rx_buffer_empty, "rx_buffer_empty");// Port 16
+         ncsc_replace_name(parity_error, "parity_error");      // Port 17
+         ncsc_replace_name(framing_error, "framing_error");    // Port 18
+         ncsc_replace_name(overrun_error, "overrun_error");    // Port 19
+         ncsc_replace_name(tx_ready, "tx_ready");              // Port 20
+         ncsc_replace_name(tx_tick, "tx_tick");                // Port 21
+         ncsc_replace_name(rx_tick, "rx_tick");                // Port 22
+         ncsc_replace_name(rx_bit, "rx_bit");                  // Port 23
+         ncsc_replace_name(cts, "cts");                        // Port 24
+         ncsc_replace_name(rx_timeout, "rx_timeout");          // Port 25
+         ncsc_replace_name(irq, "irq");                        // Port 26
+         ncsc_replace_name(int_id, "int_id");                  // Port 27
+         ncsc_replace_name(match_pending, "match_pending");    // Port 28
+         ncsc_replace_name(match_index, "match_index");        // Port 29
+         ncsc_replace_name(ts_tx_event, "ts_tx_event");        // Port 30
+         ncsc_replace_name(tx_idle, "tx_idle");                // Port 31
+         
+         ncsc_replace_name(ctrl_parity_enabled, "ctrl_parity_enabled");// Port 32
+         ncsc_replace_name(ctrl_parity_even, "ctrl_parity_even");      // Port 33
+         ncsc_replace_name(ctrl_data_bits, "ctrl_data_bits");          // Port 34
+         ncsc_replace_name(ctrl_stop_bits, "ctrl_stop_bits");          // Port 35
+         ncsc_replace_name(ctrl_de_guard, "ctrl_de_guard");            // Port 36
+         
+         ncsc_replace_name(rx_in, "rx_in");                // Port 37
+         ncsc_replace_name(tx_out, "tx_out");              // Port 38
+         ncsc_replace_name(cts_in, "cts_in");              // Port 39
+         ncsc_replace_name(rts_out, "rts_out");            // Port 40
+         ncsc_replace_name(de_out, "de_out");              // Port 41
+         ncsc_replace_name(data_in, "data_in");            // Port 42
+         ncsc_replace_name(addr, "addr");                  // Port 43
+         
+         ncsc_replace_name(dp_data_in, "dp_data_in");      // Port 44
+         ncsc_replace_name(dp_addr, "dp_addr");            // Port 45
+         ncsc_replace_name(dp_write_enable, "dp_write_enable");// Port 46
+         ncsc_replace_name(dp_ts_data, "dp_ts_data");      // Port 47
+         ncsc_replace_name(ts_count, "ts_count");          // Port 48
          
-         ncsc_replace_name(ctrl_parity_enabled, "ctrl_parity_enabled");// Port 19
-         ncsc_replace_name(ctrl_parity_even, "ctrl_parity_even");      // Port 20
-         ncsc_replace_name(ctrl_data_bits, "ctrl_data_bits");          // Port 21
-         ncsc_replace_name(ctrl_stop_bits, "ctrl_stop_bits");          // Port 22
+         ncsc_replace_name(tx_crc, "tx_crc");              // Port 49
+         ncsc_replace_name(rx_crc, "rx_crc");              // Port 50
          
-         ncsc_replace_name(rx_in, "rx_in");                // Port 23
-         ncsc_replace_name(tx_out, "tx_out");              // Port 24
-         ncsc_replace_name(data_in, "data_in");            // Port 25
-         ncsc_replace_name(data_out, "data_out");          // Port 26
-         ncsc_replace_name(addr, "addr");                  // Port 27
+         ncsc_replace_name(cfg_line_control, "cfg_line_control");// Port 51
+         ncsc_replace_name(cfg_baud_divisor, "cfg_baud_divisor");// Port 52
+         ncsc_replace_name(cfg_baud_fraction, "cfg_baud_fraction");// Port 53
+         ncsc_replace_name(cfg_fifo_control, "cfg_fifo_control");// Port 54
+         ncsc_replace_name(cfg_rx_control, "cfg_rx_control");// Port 55
+         ncsc_replace_name(cfg_modem_control, "cfg_modem_control");// Port 56
+         ncsc_replace_name(cfg_rts_threshold, "cfg_rts_threshold");// Port 57
+         ncsc_replace_name(cfg_int_enable, "cfg_int_enable");// Port 58
+         ncsc_replace_name(cfg_station, "cfg_station");  // Port 59
+         ncsc_replace_name(cfg_rs485_control, "cfg_rs485_control");// Port 60
+         ncsc_replace_name(cfg_crc_control, "cfg_crc_control");// Port 61
+         ncsc_replace_name(cfg_framing_control, "cfg_framing_control");// Port 62
+         ncsc_replace_name(cfg_match_char, "cfg_match_char");  // Port 63
          
-         ncsc_replace_name(dp_data_in, "dp_data_in");      // Port 28
-         ncsc_replace_name(dp_addr, "dp_addr");            // Port 29
-         ncsc_replace_name(dp_write_enable, "dp_write_enable");// Port 30
+         ncsc_replace_name(tx_head, "tx_head");            // Port 64
+         ncsc_replace_name(rx_tail, "rx_tail");            // Port 65
+         ncsc_replace_name(tx_tail, "tx_tail");            // Port 66
+         ncsc_replace_name(rx_head, "rx_head");            // Port 67
          
-         ncsc_replace_name(start, "start");                // Port 31
-         ncsc_replace_name(mem_we, "mem_we");              // Port 32
+         ncsc_replace_name(start, "start");                // Port 68
+         ncsc_replace_name(mem_we, "mem_we");              // Port 69
      }
  #endif
  };
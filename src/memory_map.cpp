@@ -11,55 +11,11 @@
  
  using namespace std;
  
- // Memory map address definitions
- #define TX_BUFFER_START     0   // 16 bytes (0-15)
- #define RX_BUFFER_START    16   // 16 bytes (16-31)
- #define CONFIG_REG_START   32   // 6 bytes (32-37)
- #define STATUS_REG_START   38   // 2 bytes (38-39)
- 
- // Configuration register addresses
- #define BAUD_RATE_LOW      32   // Baud rate divisor (low byte)
- #define BAUD_RATE_HIGH     33   // Baud rate divisor (high byte)
- #define LINE_CONTROL_REG   34   // Line control register (data bits, parity, stop bits)
- #define FIFO_CONTROL_REG   35   // FIFO control register (enable, trigger levels)
- #define SCRATCH_REG1       36   // Scratch register 1 (general purpose)
- #define SCRATCH_REG2       37   // Scratch register 2 (general purpose)
- 
- // Status register addresses
- #define LINE_STATUS_REG    38   // Line status register (errors, buffer status)
- #define FIFO_STATUS_REG    39   // FIFO status register (buffer levels)
- 
- // Line control register bit definitions
- #define LCR_DATA_BITS_MASK 0x03 // Bits 0-1: Data bits (0=5, 1=6, 2=7, 3=8)
- #define LCR_STOP_BITS      0x04 // Bit 2: Stop bits (0=1, 1=2)
- #define LCR_PARITY_ENABLE  0x08 // Bit 3: Parity enable
- #define LCR_PARITY_EVEN    0x10 // Bit 4: Even parity when set, odd when clear
- #define LCR_STICK_PARITY   0x20 // Bit 5: Stick parity
- #define LCR_BREAK_CONTROL  0x40 // Bit 6: Break control
- #define LCR_DLAB           0x80 // Bit 7: Divisor latch access bit
- 
- // Line status register bit definitions
- #define LSR_DATA_READY     0x01 // Bit 0: Data ready
- #define LSR_OVERRUN_ERROR  0x02 // Bit 1: Overrun error
- #define LSR_PARITY_ERROR   0x04 // Bit 2: Parity error
- #define LSR_FRAMING_ERROR  0x08 // Bit 3: Framing error
- #define LSR_BREAK_DETECT   0x10 // Bit 4: Break detect
- #define LSR_TX_EMPTY       0x20 // Bit 5: TX holding register empty
- #define LSR_TX_IDLE        0x40 // Bit 6: TX shift register empty
- #define LSR_RX_FIFO_ERROR  0x80 // Bit 7: RX FIFO error
- 
- // FIFO status register bit definitions
- #define FSR_TX_FULL        0x01 // Bit 0: TX buffer full
- #define FSR_RX_EMPTY       0x02 // Bit 1: RX buffer empty
- #define FSR_TX_ALMOST_FULL 0x04 // Bit 2: TX buffer almost full
- #define FSR_RX_ALMOST_EMPTY 0x08 // Bit 3: RX buffer almost empty
- #define FSR_TX_COUNT_MASK  0x70 // Bits 4-6: TX buffer count (0-7)
- #define FSR_RX_COUNT_MASK  0x80 // Bit 7: RX buffer count (0-7)
- 
  void memory_map::process() {
      {
          HLS_DEFINE_PROTOCOL("reset");
          reset();
+         write_outputs();
      }
      
      {       
@@ -93,28 +49,90 @@
              wait();
          }
          
+#if !UART_SINGLE_CYCLE
          // Additional wait for processing time
          {       
              HLS_DEFINE_PROTOCOL("wait");
              wait();
          }
+#endif
      }
  }
  
  void memory_map::reset() {
-     // Initialize all memory to zero
-     for (int i = 0; i < RAM_SIZE; ++i) {
-         Memory[i] = 0;
+     // Initialize all banks to zero
+     for (int i = 0; i < TX_BUFFER_SIZE; ++i) {
+         TxBank[i] = 0;
+     }
+     for (int i = 0; i < RX_BUFFER_SIZE; ++i) {
+         RxBank[i] = 0;
+         RxTsBank[i] = 0;
+     }
+     for (int i = 0; i < REG_BANK_SIZE; ++i) {
+         RegBank[i] = 0;
      }
      
      // Initialize default configuration registers
-     Memory[BAUD_RATE_LOW] = 0x03;     // Default baud rate divisor: 9600 baud
-     Memory[BAUD_RATE_HIGH] = 0x00;    // (assuming 1.8432MHz clock)
-     Memory[LINE_CONTROL_REG] = 0x03;  // 8 data bits, 1 stop bit, no parity
-     Memory[FIFO_CONTROL_REG] = 0x01;  // Enable FIFOs
+     RegBank[REG_INDEX(BAUD_RATE_LOW)] = 0x03;     // Default baud rate divisor: 9600 baud
+     RegBank[REG_INDEX(BAUD_RATE_HIGH)] = 0x00;    // (assuming 1.8432MHz clock)
+     RegBank[REG_INDEX(BAUD_RATE_FRAC)] = 0x00;    // No fractional part
+     RegBank[REG_INDEX(RX_CONTROL_REG)] = 0x00;    // 16x oversampling
+     RegBank[REG_INDEX(MODEM_CONTROL_REG)] = 0x02; // RTS asserted, no auto flow
+     RegBank[REG_INDEX(RTS_THRESHOLD_REG)] = RTS_THRESHOLD_DEFAULT;
+     RegBank[REG_INDEX(LINE_CONTROL_REG)] = 0x03;  // 8 data bits, 1 stop bit, no parity
+     RegBank[REG_INDEX(FIFO_CONTROL_REG)] = 0x01;  // Enable FIFOs, RX trigger 1, TX low water 0
+     RegBank[REG_INDEX(INT_ENABLE_REG)] = 0x00;    // All interrupts masked
+     RegBank[REG_INDEX(INT_IDENT_REG)] = 0xC1;     // FIFOs enabled, nothing pending
+     RegBank[REG_INDEX(STATION_ADDR_REG)] = 0x00;  // Station address 0
+     RegBank[REG_INDEX(STATION_MASK_REG)] = 0xFF;  // Compare all address bits
+     RegBank[REG_INDEX(RS485_CONTROL_REG)] = 0x00; // DE off, no echo suppression
+     RegBank[REG_INDEX(CRC_CONTROL_REG)] = 0x00;   // Frame check engine off
+     crc_clear_toggles = 0;
+     RegBank[REG_INDEX(FRAMING_CONTROL_REG)] = 0x00; // No byte stuffing
+     RegBank[REG_INDEX(MATCH_CHAR_REG)] = 0x00;    // Character match off
+     RegBank[REG_INDEX(MATCH_INDEX_REG)] = 0x00;
+     RegBank[REG_INDEX(TS_CONTROL_REG)] = 0x00;    // RX FIFO, byte 0
+     RegBank[REG_INDEX(TS_DATA_REG)] = 0x00;
+     RegBank[REG_INDEX(RX_LANE_ERROR_REG)] = 0x00;
+     
+     // TX timestamp FIFO starts empty, the counter from 0
+     for (int i = 0; i < TS_FIFO_SIZE; ++i) {
+         TxTsBank[i] = 0;
+     }
+     cycle_count = 0;
+     ts_tx_seen = false;
+     tx_ts_head = 0;
+     tx_ts_tail = 0;
+     tx_ts_overflow = false;
+     
+     // Load the datapath's configuration shadows with the defaults
+     update_config_shadow(LINE_CONTROL_REG);
+     update_config_shadow(BAUD_RATE_LOW);
+     update_config_shadow(BAUD_RATE_FRAC);
+     update_config_shadow(FIFO_CONTROL_REG);
+     update_config_shadow(RX_CONTROL_REG);
+     update_config_shadow(MODEM_CONTROL_REG);
+     update_config_shadow(RTS_THRESHOLD_REG);
+     update_config_shadow(INT_ENABLE_REG);
+     update_config_shadow(STATION_ADDR_REG);
+     update_config_shadow(RS485_CONTROL_REG);
+     update_config_shadow(CRC_CONTROL_REG);
+     update_config_shadow(FRAMING_CONTROL_REG);
+     update_config_shadow(MATCH_CHAR_REG);
+     
+     // Both rings start empty
+     tx_buf_head = 0;
+     rx_buf_tail = 0;
+     data_port_active = false;
+     rx_store_head = 0;
+     rx_error_count = 0;
+     rx_lane_errors = 0;
+     burst_active = false;
+     burst_addr = 0;
      
      // Initialize output values
      out_data_out = 0;
+     out_byte_valid = 0;
      out_dp_data_out = 0;
  }
  
@@ -129,59 +147,145 @@
 
      in_read_write = read_write.read();
      in_write_enable = write_enable.read();
+     in_byte_enable = byte_enable.read();
+     in_burst = burst.read();
      in_dp_data_in = dp_data_in.read();
      in_dp_addr = dp_addr.read();
      in_dp_write_enable = dp_write_enable.read();
+     in_dp_ts_data = dp_ts_data.read();
+     in_tx_fetch_addr = tx_fetch_addr.read();
 
      in_tx_buffer_full = tx_buffer_full.read();
      in_rx_buffer_empty = rx_buffer_empty.read();
      in_error_indicator = error_indicator.read();
+     in_int_id = int_id.read();
+     in_rx_timeout = rx_timeout.read();
+     in_tx_tail = tx_tail.read();
+     in_rx_head = rx_head.read();
+     in_tx_crc = tx_crc.read();
+     in_rx_crc = rx_crc.read();
+     in_match_pending = match_pending.read();
+     in_match_index = match_index.read();
+     in_ts_tx_event = ts_tx_event.read();
+     in_tx_idle = tx_idle.read();
  }
  
  void memory_map::write_outputs() {
      // Update all output ports
      data_out.write(out_data_out);
+     byte_valid.write(out_byte_valid);
      dp_data_out.write(out_dp_data_out);
+     tx_head.write(tx_buf_head);
+     cfg_line_control.write(out_cfg_line_control);
+     cfg_baud_divisor.write(out_cfg_baud_divisor);
+     cfg_baud_fraction.write(out_cfg_baud_fraction);
+     cfg_fifo_control.write(out_cfg_fifo_control);
+     cfg_rx_control.write(out_cfg_rx_control);
+     cfg_modem_control.write(out_cfg_modem_control);
+     cfg_rts_threshold.write(out_cfg_rts_threshold);
+     cfg_int_enable.write(out_cfg_int_enable);
+     cfg_station.write(out_cfg_station);
+     cfg_rs485_control.write(out_cfg_rs485_control);
+     cfg_crc_control.write(out_cfg_crc_control);
+     cfg_framing_control.write(out_cfg_framing_control);
+     cfg_match_char.write(out_cfg_match_char);
+     rx_tail.write(rx_buf_tail);
+     ts_count.write(cycle_count);
  }
  
  void memory_map::compute() {
-     // Reset logi
-     if (in_rst) {
+     // Reset logic, active low like the thread reset
+     if (!in_rst) {
          reset();
          return;
      }
      
-     // Handle datapath memory access (higher priority)
+     // Datapath write port: RX stores land in the RX bank, autobaud
+     // write-back in the register bank. TX fetches have their own read
+     // port, so neither waits on the host.
      if (in_dp_write_enable) {
-         if (in_dp_addr < RAM_SIZE) {
-             Memory[in_dp_addr] = in_dp_data_in;
+         if (in_dp_addr >= RX_BUFFER_START && in_dp_addr < CONFIG_REG_START) {
+             // A store past the last one extends the counted part of
+             // the ring up to it; one inside it replaces a counted entry
+             sc_uint<RX_FIFO_DEPTH_LOG2> slot = in_dp_addr - RX_BUFFER_START;
+             sc_uint<RX_FIFO_DEPTH_LOG2> offset = slot - rx_buf_tail.range(RX_FIFO_DEPTH_LOG2 - 1, 0);
+             sc_uint<RX_PTR_W> fill = rx_store_head - rx_buf_tail;
+             
+             // The entry's start-bit stamp goes in the slot beside it
+             RxTsBank[slot] = in_dp_ts_data;
+             
+             if (offset < fill) {
+                 replace_rx_entry(slot, in_dp_data_in);
+             } else {
+                 RxBank[slot] = in_dp_data_in;
+                 rx_store_head = rx_buf_tail + offset + 1;
+                 
+                 if (RX_ENTRY_ERRORS(in_dp_data_in) != 0) {
+                     rx_error_count = rx_error_count + 1;
+                 }
+             }
+         } else if (in_dp_addr >= CONFIG_REG_START && in_dp_addr < RAM_SIZE) {
+             RegBank[REG_INDEX(in_dp_addr)] = in_dp_data_in;
+             update_config_shadow(in_dp_addr);
          }
      }
      
+     update_timestamps();
+     
+     // Burst access: the host presents the start address on the first
+     // beat, every following cycle with burst held is the next beat at
+     // the next address. Bursts on the data port stay on it and move
+     // one FIFO access per beat.
+     sc_uint<ADDR_W> host_addr = in_addr;
+     
+     if (in_chip_select && in_burst) {
+         if (burst_active) {
+             host_addr = burst_addr;
+         }
+         burst_active = true;
+         burst_addr = (host_addr == DATA_PORT_REG) ? host_addr : (sc_uint<ADDR_W>)(host_addr + 1);
+     } else {
+         burst_active = false;
+     }
+     
+     // Byte lanes taking part in a data port access
+ #if UART_WIDE_BUS
+     sc_uint<HOST_LANES> lanes = in_byte_enable;
+ #else
+     sc_uint<HOST_LANES> lanes = 1;
+ #endif
+     
+     out_byte_valid = 0;
+     
      // CPU memory access
-     if (in_chip_select) {
+     if (in_chip_select && host_addr == DATA_PORT_REG) {
+         // Single accesses pop or push once per chip select, however
+         // many cycles the host holds them; bursts act on every beat
+         if (!data_port_active || in_burst) {
+             if (!in_read_write) {
+                 out_data_out = read_data_port(lanes);
+                 data_port_active = true;
+             } else if (in_write_enable) {
+                 write_data_port(in_data_in, lanes);
+                 data_port_active = true;
+             }
+         }
+     } else if (in_chip_select) {
          if (!in_read_write) {
              // Read operation
-             if (in_addr < RAM_SIZE) {
-                 out_data_out = Memory[in_addr];
-             } else {
-                 // Invalid address
-                 out_data_out = 0xFF;
-             }
+             out_data_out = host_read(host_addr);
          } else if (in_write_enable) {
              // Write operation
-             if (in_addr < RAM_SIZE) {
-                 Memory[in_addr] = in_data_in;
-             }
+             host_write(host_addr, in_data_in);
          }
      }
      
-     // Always update datapath data output regardless of read/write operations
-     if (in_dp_addr < RAM_SIZE) {
-         out_dp_data_out = Memory[in_dp_addr];
-     } else {
-         out_dp_data_out = 0;
+     if (!in_chip_select || host_addr != DATA_PORT_REG) {
+         data_port_active = false;
      }
+     
+     // TX fetch port - the datapath's holding register load
+     out_dp_data_out = TxBank[in_tx_fetch_addr.range(TX_FIFO_DEPTH_LOG2 - 1, 0)];
  }
  
  void memory_map::commit() {
@@ -198,13 +302,13 @@
          line_status |= LSR_DATA_READY;
      }
      
-     // Set TX empty flag if TX buffer not full
-     if (!in_tx_buffer_full) {
+     // THRE: the TX ring is empty. TEMT: it is empty and the last
+     // frame has left the transmitter as well.
+     bool tx_ring_empty = (tx_buf_head == in_tx_tail);
+     if (tx_ring_empty) {
          line_status |= LSR_TX_EMPTY;
      }
-     
-     // Set TX idle flag (when transmitter is completely idle)
-     if (!in_tx_buffer_full) {
+     if (tx_ring_empty && in_tx_idle) {
          line_status |= LSR_TX_IDLE;
      }
      
@@ -214,8 +318,31 @@
          line_status |= LSR_PARITY_ERROR | LSR_FRAMING_ERROR;
      }
      
+     // Per-character errors describe the byte the next RBR read returns
+     if (rx_buf_tail != in_rx_head) {
+         sc_uint<RX_ENTRY_W> head = RxBank[rx_buf_tail.range(RX_FIFO_DEPTH_LOG2 - 1, 0)];
+         
+         if (head[RX_TAG_PARITY]) {
+             line_status |= LSR_PARITY_ERROR;
+         }
+         if (head[RX_TAG_FRAMING]) {
+             line_status |= LSR_FRAMING_ERROR;
+         }
+         if (head[RX_TAG_BREAK]) {
+             line_status |= LSR_BREAK_DETECT;
+         }
+         if (head[RX_TAG_FRAME_END]) {
+             line_status |= LSR_FRAME_END;
+         }
+     }
+     
+     // At least one tagged byte still in the ring
+     if (rx_error_count != 0) {
+         line_status |= LSR_RX_FIFO_ERROR;
+     }
+     
      // Update line status register (read-only register)
-     Memory[LINE_STATUS_REG] = line_status;
+     RegBank[REG_INDEX(LINE_STATUS_REG)] = line_status;
      
      // Update FIFO status register
      sc_uint<DATA_W> fifo_status = 0;
@@ -230,35 +357,312 @@
          fifo_status |= FSR_RX_EMPTY;
      }
      
+     // Set RX timeout flag
+     if (in_rx_timeout) {
+         fifo_status |= FSR_RX_TIMEOUT;
+     }
+     
      // Update FIFO status register (read-only register)
-     Memory[FIFO_STATUS_REG] = fifo_status;
+     RegBank[REG_INDEX(FIFO_STATUS_REG)] = fifo_status;
+     
+     // Update interrupt identification register (read-only register)
+     sc_uint<DATA_W> int_ident = in_int_id & IIR_ID_MASK;
+     
+     if ((RegBank[REG_INDEX(FIFO_CONTROL_REG)] & FCR_FIFO_ENABLE) != 0) {
+         int_ident |= IIR_FIFOS_ENABLED;
+     }
+     
+     RegBank[REG_INDEX(INT_IDENT_REG)] = int_ident;
+     
+     // CRC readback, one byte of the selected direction's CRC
+     sc_uint<DATA_W> crc_control = RegBank[REG_INDEX(CRC_CONTROL_REG)];
+     sc_uint<32> crc = ((crc_control & CRC_READ_RX) != 0) ? in_rx_crc : in_tx_crc;
+     sc_uint<2> crc_byte = (crc_control & CRC_BYTE_MASK) >> CRC_BYTE_SHIFT;
+     
+     RegBank[REG_INDEX(CRC_DATA_REG)] = (crc >> (8 * crc_byte)) & 0xFF;
+     
+     // Character match: RBR reads up to and including the matched byte,
+     // 0 when none is waiting. Measured from our own read pointer, which
+     // runs ahead of the datapath's view, so a pop past the match reads
+     // as 0 at once.
+     sc_uint<RX_PTR_W> rx_fill = in_rx_head - rx_buf_tail;
+     sc_uint<RX_PTR_W> match_offset = in_match_index - rx_buf_tail;
+     sc_uint<RX_PTR_W + 1> match_count = 0;
+     
+     if (in_match_pending && match_offset < rx_fill) {
+         match_count = match_offset + 1;
+     }
+     if (match_count > (1 << DATA_W) - 1) {
+         match_count = (1 << DATA_W) - 1;
+     }
+     
+     RegBank[REG_INDEX(MATCH_INDEX_REG)] = match_count;
+     
+     // A wide read has no room for the tags beside each byte, so the
+     // lanes that carried one are flagged here until the next read
+     RegBank[REG_INDEX(RX_LANE_ERROR_REG)] = rx_lane_errors;
+     
+     // Timestamp readback, one byte of the selected FIFO's head. The RX
+     // head is the stamp of the byte the next RBR read returns.
+     sc_uint<DATA_W> ts_control = RegBank[REG_INDEX(TS_CONTROL_REG)] & (TS_SELECT_TX | TS_BYTE_MASK);
+     bool ts_tx = (ts_control & TS_SELECT_TX) != 0;
+     bool ts_ready = ts_tx ? (tx_ts_head != tx_ts_tail) : (rx_buf_tail != in_rx_head);
+     sc_uint<32> stamp = ts_tx ? TxTsBank[tx_ts_tail.range(TS_FIFO_DEPTH_LOG2 - 1, 0)]
+                               : RxTsBank[rx_buf_tail.range(RX_FIFO_DEPTH_LOG2 - 1, 0)];
+     sc_uint<2> ts_byte = (ts_control & TS_BYTE_MASK) >> TS_BYTE_SHIFT;
+     
+     RegBank[REG_INDEX(TS_DATA_REG)] = 0;
+     if (ts_ready) {
+         ts_control |= TS_READY;
+         RegBank[REG_INDEX(TS_DATA_REG)] = (stamp >> (8 * ts_byte)) & 0xFF;
+     }
+     if (ts_tx && tx_ts_overflow) {
+         ts_control |= TS_OVERFLOW;
+     }
+     
+     RegBank[REG_INDEX(TS_CONTROL_REG)] = ts_control;
+ }
+ 
+ // Frame timestamps. cycle_count goes out on ts_count; the datapath
+ // latches it at each start bit and hands it back with the byte's RX
+ // store, so a stamp always belongs to the entry it is stored with. The
+ // datapath toggles ts_tx_event when the last stop bit of a frame ends.
+ // Both arrive with a fixed delay of a few cycles, so stamps are exact
+ // relative to one another and well inside a bit time of the line event.
+ void memory_map::update_timestamps() {
+ #if UART_SINGLE_CYCLE
+     cycle_count = cycle_count + 1;
+ #else
+     cycle_count = cycle_count + 2;
+ #endif
+     
+     if ((bool)in_ts_tx_event != ts_tx_seen) {
+         if ((tx_ts_head ^ tx_ts_tail) == TS_FIFO_SIZE) {
+             tx_ts_overflow = true;
+         } else {
+             TxTsBank[tx_ts_head.range(TS_FIFO_DEPTH_LOG2 - 1, 0)] = cycle_count;
+             tx_ts_head = tx_ts_head + 1;
+         }
+     }
+     
+     ts_tx_seen = in_ts_tx_event;
  }
  
  // Helper methods for accessing specific memory regions
  sc_uint<DATA_W> memory_map::get_tx_buffer(unsigned int index) {
      if (index < TX_BUFFER_SIZE) {
-         return Memory[TX_BUFFER_START + index];
+         return TxBank[index];
      }
      return 0;
  }
  
  void memory_map::set_tx_buffer(unsigned int index, sc_uint<DATA_W> value) {
      if (index < TX_BUFFER_SIZE) {
-         Memory[TX_BUFFER_START + index] = value;
+         TxBank[index] = value;
      }
  }
  
  sc_uint<DATA_W> memory_map::get_rx_buffer(unsigned int index) {
      if (index < RX_BUFFER_SIZE) {
-         return Memory[RX_BUFFER_START + index];
+         return rx_entry_to_host(RxBank[index]);
      }
      return 0;
  }
  
  void memory_map::set_rx_buffer(unsigned int index, sc_uint<DATA_W> value) {
      if (index < RX_BUFFER_SIZE) {
-         Memory[RX_BUFFER_START + index] = value;
+         replace_rx_entry(index, value.range(7, 0));
+     }
+ }
+ 
+ // Data port read (RBR) - pops the oldest RX byte into each enabled
+ // lane, lowest lane first, and flags the lanes it filled in
+ // byte_valid, and the lanes whose byte is error tagged in
+ // RX_LANE_ERROR_REG. The datapath's head pointer arrives a cycle late,
+ // so the ring can only look emptier than it is, never hand out a slot
+ // not yet written. Lanes the ring cannot fill read as 0.
+ sc_uint<HOST_DATA_W> memory_map::read_data_port(sc_uint<HOST_LANES> lanes) {
+     sc_uint<HOST_DATA_W> value = 0;
+     
+     rx_lane_errors = 0;
+     
+     for (int i = 0; i < HOST_LANES; i++) {
+         if (lanes[i] && rx_buf_tail != in_rx_head) {
+             sc_uint<RX_ENTRY_W> entry = RxBank[rx_buf_tail.range(RX_FIFO_DEPTH_LOG2 - 1, 0)];
+ #if UART_WIDE_BUS
+             value.range(8 * i + 7, 8 * i) = entry.range(7, 0);
+ #else
+             value = rx_entry_to_host(entry);
+ #endif
+             if (RX_ENTRY_ERRORS(entry) != 0) {
+                 rx_lane_errors[i] = 1;
+             }
+             // Only stored entries were counted; a pop past the last
+             // store carries the counted range along with it
+             if (rx_buf_tail == rx_store_head) {
+                 rx_store_head = rx_store_head + 1;
+             } else if (RX_ENTRY_ERRORS(entry) != 0) {
+                 rx_error_count = rx_error_count - 1;
+             }
+             out_byte_valid[i] = 1;
+             rx_buf_tail = rx_buf_tail + 1;
+         }
+     }
+     
+     return value;
+ }
+ 
+ // Data port write (THR) - appends each enabled lane to the TX ring,
+ // lowest lane first, and advances the head the datapath transmits
+ // from. Bytes that find the ring full are dropped.
+ void memory_map::write_data_port(sc_uint<HOST_DATA_W> value, sc_uint<HOST_LANES> lanes) {
+     for (int i = 0; i < HOST_LANES; i++) {
+         if (lanes[i] && (tx_buf_head ^ in_tx_tail) != TX_BUFFER_SIZE) {
+ #if UART_WIDE_BUS
+             TxBank[tx_buf_head.range(TX_FIFO_DEPTH_LOG2 - 1, 0)] = value.range(8 * i + 7, 8 * i);
+ #else
+             TxBank[tx_buf_head.range(TX_FIFO_DEPTH_LOG2 - 1, 0)] = value;
+ #endif
+             tx_buf_head = tx_buf_head + 1;
+         }
+     }
+ }
+ 
+ // RX entry to host format: the data byte, with bit 8 set when any
+ // error tag is present. The individual tags, and the SLIP frame end,
+ // are read through LSR.
+ sc_uint<DATA_W> memory_map::rx_entry_to_host(sc_uint<RX_ENTRY_W> entry) {
+     sc_uint<DATA_W> value = entry.range(7, 0);
+     
+     if (RX_ENTRY_ERRORS(entry) != 0) {
+         value |= RBR_ERROR;
      }
+     
+     return value;
+ }
+ 
+ // Host access decode across the three banks
+ sc_uint<DATA_W> memory_map::host_read(sc_uint<ADDR_W> address) {
+     if (address < RX_BUFFER_START) {
+         return TxBank[address - TX_BUFFER_START];
+     } else if (address < CONFIG_REG_START) {
+         return rx_entry_to_host(RxBank[address - RX_BUFFER_START]);
+     } else if (address < RAM_SIZE) {
+         return RegBank[REG_INDEX(address)];
+     }
+     
+     // Invalid address
+     return 0xFF;
+ }
+ 
+ void memory_map::host_write(sc_uint<ADDR_W> address, sc_uint<DATA_W> value) {
+     if (address < RX_BUFFER_START) {
+         TxBank[address - TX_BUFFER_START] = value;
+     } else if (address < CONFIG_REG_START) {
+         replace_rx_entry(address - RX_BUFFER_START, value.range(7, 0));
+     } else if (address < RAM_SIZE) {
+         RegBank[REG_INDEX(address)] = value;
+         if (address == TS_CONTROL_REG) {
+             write_ts_control();
+         }
+         update_config_shadow(address);
+     }
+ }
+ 
+ // Host overwrite of an RX bank entry. Entries from the read pointer up
+ // to the last datapath store are counted in rx_error_count, so when one
+ // of them is replaced its tags leave the count and the new entry's join.
+ void memory_map::replace_rx_entry(sc_uint<RX_FIFO_DEPTH_LOG2> index, sc_uint<RX_ENTRY_W> entry) {
+     sc_uint<RX_FIFO_DEPTH_LOG2> offset = index - rx_buf_tail.range(RX_FIFO_DEPTH_LOG2 - 1, 0);
+     sc_uint<RX_PTR_W> fill = rx_store_head - rx_buf_tail;
+     
+     if (offset < fill) {
+         if (RX_ENTRY_ERRORS(RxBank[index]) != 0) {
+             rx_error_count = rx_error_count - 1;
+         }
+         if (RX_ENTRY_ERRORS(entry) != 0) {
+             rx_error_count = rx_error_count + 1;
+         }
+     }
+     
+     RxBank[index] = entry;
+ }
+ 
+ // Copy a configuration register to its datapath shadow port. Called
+ // only when the register is written, so the datapath picks up new
+ // settings without spending its memory port on them.
+ void memory_map::update_config_shadow(sc_uint<ADDR_W> address) {
+     switch (address) {
+         case LINE_CONTROL_REG:
+             out_cfg_line_control = RegBank[REG_INDEX(LINE_CONTROL_REG)];
+             break;
+         case BAUD_RATE_LOW:
+         case BAUD_RATE_HIGH:
+             out_cfg_baud_divisor = (RegBank[REG_INDEX(BAUD_RATE_HIGH)].range(7, 0), RegBank[REG_INDEX(BAUD_RATE_LOW)].range(7, 0));
+             break;
+         case BAUD_RATE_FRAC:
+             out_cfg_baud_fraction = RegBank[REG_INDEX(BAUD_RATE_FRAC)].range(7, 0);
+             break;
+         case FIFO_CONTROL_REG:
+             out_cfg_fifo_control = RegBank[REG_INDEX(FIFO_CONTROL_REG)];
+             break;
+         case RX_CONTROL_REG:
+             out_cfg_rx_control = RegBank[REG_INDEX(RX_CONTROL_REG)];
+             break;
+         case MODEM_CONTROL_REG:
+             out_cfg_modem_control = RegBank[REG_INDEX(MODEM_CONTROL_REG)];
+             break;
+         case RTS_THRESHOLD_REG:
+             out_cfg_rts_threshold = RegBank[REG_INDEX(RTS_THRESHOLD_REG)];
+             break;
+         case INT_ENABLE_REG:
+             out_cfg_int_enable = RegBank[REG_INDEX(INT_ENABLE_REG)];
+             break;
+         case STATION_ADDR_REG:
+         case STATION_MASK_REG:
+             out_cfg_station = (RegBank[REG_INDEX(STATION_MASK_REG)].range(7, 0), RegBank[REG_INDEX(STATION_ADDR_REG)].range(7, 0));
+             break;
+         case RS485_CONTROL_REG:
+             out_cfg_rs485_control = RegBank[REG_INDEX(RS485_CONTROL_REG)];
+             break;
+         case CRC_CONTROL_REG: {
+             // The clear bits are requests, not state. Each one flips its
+             // toggle on the shadow, so the datapath sees every request
+             // even if it was stalled while the write went by.
+             sc_uint<DATA_W> crc_control = RegBank[REG_INDEX(CRC_CONTROL_REG)];
+             
+             crc_clear_toggles ^= crc_control & (CRC_TX_CLEAR | CRC_RX_CLEAR);
+             crc_control &= ~(CRC_TX_CLEAR | CRC_RX_CLEAR);
+             RegBank[REG_INDEX(CRC_CONTROL_REG)] = crc_control;
+             
+             out_cfg_crc_control = (crc_control & CRC_MODE_MASK) | crc_clear_toggles;
+             break;
+         }
+         case FRAMING_CONTROL_REG:
+             out_cfg_framing_control = RegBank[REG_INDEX(FRAMING_CONTROL_REG)];
+             break;
+         case MATCH_CHAR_REG:
+             out_cfg_match_char = RegBank[REG_INDEX(MATCH_CHAR_REG)];
+             break;
+         default:
+             break;
+     }
+ }
+ 
+ // Host write to TS_CONTROL_REG. Pop is a request, not state: it drops
+ // the TX FIFO's head and acknowledges its overflow. RX stamps leave
+ // with their byte on the RBR read, so a pop of the RX side does nothing.
+ void memory_map::write_ts_control() {
+     sc_uint<DATA_W> ts_control = RegBank[REG_INDEX(TS_CONTROL_REG)];
+     
+     if ((ts_control & TS_POP) != 0 && (ts_control & TS_SELECT_TX) != 0) {
+         if (tx_ts_head != tx_ts_tail) {
+             tx_ts_tail = tx_ts_tail + 1;
+         }
+         tx_ts_overflow = false;
+     }
+     
+     RegBank[REG_INDEX(TS_CONTROL_REG)] = ts_control & (TS_SELECT_TX | TS_BYTE_MASK);
  }
  
  // Helper methods for memory access
@@ -268,5 +672,5 @@
  
  void memory_map::clear_errors() {
      // Clear error bits in the line status register
-     Memory[LINE_STATUS_REG] &= ~(LSR_PARITY_ERROR | LSR_FRAMING_ERROR | LSR_OVERRUN_ERROR);
+     RegBank[REG_INDEX(LINE_STATUS_REG)] &= ~(LSR_PARITY_ERROR | LSR_FRAMING_ERROR | LSR_OVERRUN_ERROR);
  }
\ No newline at end of file
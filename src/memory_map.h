@@ -1,75 +1,244 @@
+/**************************************************************
+ * File Name: memory_map.h
+ * Authors: Luke Guenthner, Nguyen Nguyen, Marcellus Wilson
+ * Date: 4/29/2025
+ *
+ * Contains the SystemC Module Header for the UART memory map
+ **************************************************************/
+
 #ifndef __MEMORY_MAP_H__
 #define __MEMORY_MAP_H__
 
 #include "systemc.h"
+#include "stratus_hls.h"
 #include "sizes.h"
 
-class memory_map {
-public:
-    bool rst;
-    <sc_uint<DATA_W>> data_in;
-    <sc_uint<DATA_W>> data_out;
-    <sc_uint<ADDR_W>> addr;
-    bool chip_select;
-    bool read_write;
-    bool write_enable;
-    
+SC_MODULE(memory_map) {
+    // Clock and reset
+    sc_in<bool> clk;                        // Port 0
+    sc_in<bool> rst;                        // Port 1
+
+    // Host interface
+    sc_in<sc_uint<HOST_DATA_W>> data_in;    // Port 2
+    sc_out<sc_uint<HOST_DATA_W>> data_out;  // Port 3
+    sc_in<sc_uint<ADDR_W>> addr;            // Port 4
+    sc_in<bool> chip_select;                // Port 5
+    sc_in<bool> read_write;                 // Port 6
+    sc_in<bool> write_enable;               // Port 7
+    sc_in<sc_uint<HOST_LANES>> byte_enable; // Port 8 - Data port lanes (wide bus)
+    sc_in<bool> burst;                      // Port 9 - Auto-increment burst
+    sc_out<sc_uint<HOST_LANES>> byte_valid; // Port 10 - Lanes filled by a pop
+
     // Interface to datapath
-    <sc_uint<DATA_W>> dp_data_out;
-    <sc_uint<DATA_W>> dp_data_in;
-    <sc_uint<ADDR_W>> dp_addr;
-    bool dp_write_enable;
-    
+    sc_out<sc_uint<DATA_W>> dp_data_out;    // Port 11
+    sc_in<sc_uint<RX_ENTRY_W>> dp_data_in;  // Port 12
+    sc_in<sc_uint<ADDR_W>> dp_addr;         // Port 13
+    sc_in<bool> dp_write_enable;            // Port 14
+    sc_in<sc_uint<32>> dp_ts_data;          // Port 15 - Start-bit stamp of the RX entry being stored
+    sc_in<sc_uint<ADDR_W>> tx_fetch_addr;   // Port 16 - TX ring read address
+    sc_out<sc_uint<32>> ts_count;           // Port 17 - Timestamp counter
+
+    // Configuration shadows to datapath
+    sc_out<sc_uint<DATA_W>> cfg_line_control; // Port 18 - Line control register
+    sc_out<sc_uint<16>> cfg_baud_divisor;   // Port 19 - Baud divisor, high:low
+    sc_out<sc_uint<8>> cfg_baud_fraction;   // Port 20 - Baud divisor fraction
+    sc_out<sc_uint<DATA_W>> cfg_fifo_control; // Port 21 - FIFO control register
+    sc_out<sc_uint<DATA_W>> cfg_rx_control; // Port 22 - Receiver control register
+    sc_out<sc_uint<DATA_W>> cfg_modem_control; // Port 23 - Modem control register
+    sc_out<sc_uint<DATA_W>> cfg_rts_threshold; // Port 24 - Auto-RTS threshold
+    sc_out<sc_uint<DATA_W>> cfg_int_enable; // Port 25 - Interrupt enable register
+    sc_out<sc_uint<16>> cfg_station;        // Port 26 - Station mask:address
+    sc_out<sc_uint<DATA_W>> cfg_rs485_control; // Port 27 - RS-485 control register
+    sc_out<sc_uint<DATA_W>> cfg_crc_control; // Port 28 - CRC mode and clear toggles
+    sc_out<sc_uint<DATA_W>> cfg_framing_control; // Port 29 - Byte-stuffing framer modes
+    sc_out<sc_uint<DATA_W>> cfg_match_char; // Port 30 - Match character and enable
+
     // Status signals
-<<<<<<< HEAD
-    sc_in<bool> tx_buffer_full; //Transmit Data
-    sc_in<bool> rx_buffer_empty;//Received
-    sc_in<bool> error_indicator;
-=======
-    bool tx_buffer_full;
-    bool rx_buffer_empty;
-    bool error_indicator;
->>>>>>> 32cec010363f71286bb12aba5dad602301e17bbd
-    
-    // Memory array - single array for all memory
-    sc_uint<DATA_W> Memory[RAM_SIZE];
-    
-    // Constructor
-    memory_map();
-    
-    // Reset method
+    sc_in<bool> tx_buffer_full;             // Port 31
+    sc_in<bool> rx_buffer_empty;            // Port 32
+    sc_in<bool> error_indicator;            // Port 33
+    sc_in<sc_uint<4>> int_id;               // Port 34 - Pending interrupt code
+    sc_in<bool> rx_timeout;                 // Port 35 - RX character timeout
+    sc_in<sc_uint<32>> tx_crc;              // Port 36 - CRC of the bytes sent
+    sc_in<sc_uint<32>> rx_crc;              // Port 37 - CRC of the bytes received
+    sc_in<bool> match_pending;              // Port 38 - Matched byte still in the RX ring
+    sc_in<sc_uint<RX_PTR_W>> match_index;   // Port 39 - RX ring pointer of the matched byte
+    sc_in<bool> ts_tx_event;                // Port 40 - Toggles on each TX stop bit end
+    sc_in<bool> tx_idle;                    // Port 41 - No frame on the line or waiting to start
+
+    // Ring pointers, each side owns the pointer it advances
+    sc_out<sc_uint<TX_PTR_W>> tx_head;      // Port 42 - Host TX write pointer
+    sc_out<sc_uint<RX_PTR_W>> rx_tail;      // Port 43 - Host RX read pointer
+    sc_in<sc_uint<TX_PTR_W>> tx_tail;       // Port 44 - Datapath TX read pointer
+    sc_in<sc_uint<RX_PTR_W>> rx_head;       // Port 45 - Datapath RX write pointer
+
+    // Storage banks - each has its own ports so a host access, a TX
+    // fetch and an RX store can all complete in the same cycle
+    sc_uint<DATA_W> TxBank[TX_BUFFER_SIZE];
+    sc_uint<RX_ENTRY_W> RxBank[RX_BUFFER_SIZE];
+    sc_uint<DATA_W> RegBank[REG_BANK_SIZE];
+
+    // Frame timestamps. Each RX stamp sits beside its RX ring entry and
+    // leaves with it, TX stamps have a FIFO of their own.
+    sc_uint<32> RxTsBank[RX_BUFFER_SIZE];
+    sc_uint<32> TxTsBank[TS_FIFO_SIZE];
+
+    // Main process method
+    void process();
+
+    // Core methods
     void reset();
-    
-    // Main memory access method
-    void memory_access();
-    
+    void read_inputs();
+    void write_outputs();
+    void compute();
+    void commit();
+
     // Update status registers based on UART state
-    void status_update();
-    
-    // Handle register-specific updates
-    void handle_register_change(sc_uint<ADDR_W> reg_addr, sc_uint<DATA_W> value);
-    
+    void update_status_registers();
+    void update_timestamps();
+
     // Helper methods for accessing specific memory regions
     sc_uint<DATA_W> get_tx_buffer(unsigned int index);
     void set_tx_buffer(unsigned int index, sc_uint<DATA_W> value);
     sc_uint<DATA_W> get_rx_buffer(unsigned int index);
     void set_rx_buffer(unsigned int index, sc_uint<DATA_W> value);
-    
-    // Configuration access methods
-    sc_uint<DATA_W> get_baud_rate_divisor();
-    bool get_parity_enabled();
-    bool get_parity_even();
-    unsigned int get_data_bits();
-    unsigned int get_stop_bits();
-    
-    // Standard compute/commit methods for HLS pattern
-    void compute();
-    void commit();
+    bool is_valid_address(sc_uint<ADDR_W> address);
+    sc_uint<DATA_W> rx_entry_to_host(sc_uint<RX_ENTRY_W> entry);
+    void replace_rx_entry(sc_uint<RX_FIFO_DEPTH_LOG2> index, sc_uint<RX_ENTRY_W> entry);
+    sc_uint<DATA_W> host_read(sc_uint<ADDR_W> address);
+    void host_write(sc_uint<ADDR_W> address, sc_uint<DATA_W> value);
+    void update_config_shadow(sc_uint<ADDR_W> address);
+    void write_ts_control();
+    void clear_errors();
+
+    // Data port registers - pop/push the rings on access
+    sc_uint<HOST_DATA_W> read_data_port(sc_uint<HOST_LANES> lanes);
+    void write_data_port(sc_uint<HOST_DATA_W> value, sc_uint<HOST_LANES> lanes);
+
+    // Host-side ring pointers
+    sc_uint<TX_PTR_W> tx_buf_head;          // Next free TX slot
+    sc_uint<RX_PTR_W> rx_buf_tail;          // Oldest unread RX byte
+    bool data_port_active;                  // Data port access already taken
+    sc_uint<RX_PTR_W> rx_store_head;        // One past the last datapath RX store
+    sc_uint<RX_PTR_W> rx_error_count;       // Error-tagged bytes between rx_buf_tail and rx_store_head
+    sc_uint<HOST_LANES> rx_lane_errors;     // Lanes of the last data port read holding a tagged byte
+    sc_uint<DATA_W> crc_clear_toggles;      // CRC clear requests, one toggle bit per direction
+
+    // Frame timestamps
+    sc_uint<32> cycle_count;                // Free-running clock cycle counter
+    bool ts_tx_seen;                        // Last ts_tx_event level
+    sc_uint<TS_PTR_W> tx_ts_head;           // TX stamp FIFO write pointer
+    sc_uint<TS_PTR_W> tx_ts_tail;           // TX stamp FIFO read pointer
+    bool tx_ts_overflow;                    // TX stamp dropped on a full FIFO
 
-private:
-    // Temporary values computed in compute()
-    sc_uint<DATA_W> next_out_dout;
-    sc_uint<4> next_out_io_out;
+    // Burst state
+    bool burst_active;                      // Past the first beat
+    sc_uint<ADDR_W> burst_addr;             // Address of the next beat
+
+    // Internal input values
+    sc_bit in_rst;
+    sc_uint<HOST_DATA_W> in_data_in;
+    sc_uint<ADDR_W> in_addr;
+    sc_bit in_chip_select;
+    sc_bit in_read_write;
+    sc_bit in_write_enable;
+    sc_uint<HOST_LANES> in_byte_enable;
+    sc_bit in_burst;
+    sc_uint<RX_ENTRY_W> in_dp_data_in;
+    sc_uint<ADDR_W> in_dp_addr;
+    sc_bit in_dp_write_enable;
+    sc_uint<32> in_dp_ts_data;
+    sc_uint<ADDR_W> in_tx_fetch_addr;
+    sc_bit in_tx_buffer_full;
+    sc_bit in_rx_buffer_empty;
+    sc_bit in_error_indicator;
+    sc_uint<4> in_int_id;
+    sc_bit in_rx_timeout;
+    sc_uint<TX_PTR_W> in_tx_tail;
+    sc_uint<RX_PTR_W> in_rx_head;
+    sc_uint<32> in_tx_crc;
+    sc_uint<32> in_rx_crc;
+    sc_bit in_match_pending;
+    sc_uint<RX_PTR_W> in_match_index;
+    sc_bit in_ts_tx_event;
+    sc_bit in_tx_idle;
+
+    // Internal output values
+    sc_uint<HOST_DATA_W> out_data_out;
+    sc_uint<HOST_LANES> out_byte_valid;
+    sc_uint<DATA_W> out_dp_data_out;
+    sc_uint<DATA_W> out_cfg_line_control;
+    sc_uint<16> out_cfg_baud_divisor;
+    sc_uint<8> out_cfg_baud_fraction;
+    sc_uint<DATA_W> out_cfg_fifo_control;
+    sc_uint<DATA_W> out_cfg_rx_control;
+    sc_uint<DATA_W> out_cfg_modem_control;
+    sc_uint<DATA_W> out_cfg_rts_threshold;
+    sc_uint<DATA_W> out_cfg_int_enable;
+    sc_uint<16> out_cfg_station;
+    sc_uint<DATA_W> out_cfg_rs485_control;
+    sc_uint<DATA_W> out_cfg_crc_control;
+    sc_uint<DATA_W> out_cfg_framing_control;
+    sc_uint<DATA_W> out_cfg_match_char;
+
+    SC_CTOR(memory_map) {
+        SC_THREAD(process);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, false);
+    }
+
+#ifdef NC_SYSTEMC
+public:
+    void ncsc_replace_names() {
+        // Replace port names for simulation
+        ncsc_replace_name(clk, "clk");                          // Port 0
+        ncsc_replace_name(rst, "rst");                          // Port 1
+        ncsc_replace_name(data_in, "data_in");                  // Port 2
+        ncsc_replace_name(data_out, "data_out");                // Port 3
+        ncsc_replace_name(addr, "addr");                        // Port 4
+        ncsc_replace_name(chip_select, "chip_select");          // Port 5
+        ncsc_replace_name(read_write, "read_write");            // Port 6
+        ncsc_replace_name(write_enable, "write_enable");        // Port 7
+        ncsc_replace_name(byte_enable, "byte_enable");          // Port 8
+        ncsc_replace_name(burst, "burst");                      // Port 9
+        ncsc_replace_name(byte_valid, "byte_valid");            // Port 10
+        ncsc_replace_name(dp_data_out, "dp_data_out");          // Port 11
+        ncsc_replace_name(dp_data_in, "dp_data_in");            // Port 12
+        ncsc_replace_name(dp_addr, "dp_addr");                  // Port 13
+        ncsc_replace_name(dp_write_enable, "dp_write_enable");  // Port 14
+        ncsc_replace_name(dp_ts_data, "dp_ts_data");            // Port 15
+        ncsc_replace_name(tx_fetch_addr, "tx_fetch_addr");      // Port 16
+        ncsc_replace_name(ts_count, "ts_count");                // Port 17
+        ncsc_replace_name(cfg_line_control, "cfg_line_control");// Port 18
+        ncsc_replace_name(cfg_baud_divisor, "cfg_baud_divisor");// Port 19
+        ncsc_replace_name(cfg_baud_fraction, "cfg_baud_fraction");// Port 20
+        ncsc_replace_name(cfg_fifo_control, "cfg_fifo_control");// Port 21
+        ncsc_replace_name(cfg_rx_control, "cfg_rx_control");    // Port 22
+        ncsc_replace_name(cfg_modem_control, "cfg_modem_control");// Port 23
+        ncsc_replace_name(cfg_rts_threshold, "cfg_rts_threshold");// Port 24
+        ncsc_replace_name(cfg_int_enable, "cfg_int_enable");    // Port 25
+        ncsc_replace_name(cfg_station, "cfg_station");          // Port 26
+        ncsc_replace_name(cfg_rs485_control, "cfg_rs485_control");// Port 27
+        ncsc_replace_name(cfg_crc_control, "cfg_crc_control");  // Port 28
+        ncsc_replace_name(cfg_framing_control, "cfg_framing_control");// Port 29
+        ncsc_replace_name(cfg_match_char, "cfg_match_char");    // Port 30
+        ncsc_replace_name(tx_buffer_full, "tx_buffer_full");    // Port 31
+        ncsc_replace_name(rx_buffer_empty, "rx_buffer_empty");  // Port 32
+        ncsc_replace_name(error_indicator, "error_indicator");  // Port 33
+        ncsc_replace_name(int_id, "int_id");                    // Port 34
+        ncsc_replace_name(rx_timeout, "rx_timeout");            // Port 35
+        ncsc_replace_name(tx_crc, "tx_crc");                    // Port 36
+        ncsc_replace_name(rx_crc, "rx_crc");                    // Port 37
+        ncsc_replace_name(match_pending, "match_pending");      // Port 38
+        ncsc_replace_name(match_index, "match_index");          // Port 39
+        ncsc_replace_name(ts_tx_event, "ts_tx_event");          // Port 40
+        ncsc_replace_name(tx_idle, "tx_idle");                  // Port 41
+        ncsc_replace_name(tx_head, "tx_head");                  // Port 42
+        ncsc_replace_name(rx_tail, "rx_tail");                  // Port 43
+        ncsc_replace_name(tx_tail, "tx_tail");                  // Port 44
+        ncsc_replace_name(rx_head, "rx_head");                  // Port 45
+    }
+#endif
 };
 
 #endif
@@ -9,21 +9,260 @@
 #ifndef __SIZES_H__
 #define __SIZES_H__
 
+// FIFO depths as log2 of the entry count, 4..12 (16 to 4096 entries).
+// Override with -DTX_FIFO_DEPTH_LOG2=n / -DRX_FIFO_DEPTH_LOG2=n
+#ifndef TX_FIFO_DEPTH_LOG2
+#define TX_FIFO_DEPTH_LOG2 4
+#endif
+#ifndef RX_FIFO_DEPTH_LOG2
+#define RX_FIFO_DEPTH_LOG2 4
+#endif
+
+#if TX_FIFO_DEPTH_LOG2 < 4 || TX_FIFO_DEPTH_LOG2 > 12
+#error "TX_FIFO_DEPTH_LOG2 must be between 4 and 12"
+#endif
+#if RX_FIFO_DEPTH_LOG2 < 4 || RX_FIFO_DEPTH_LOG2 > 12
+#error "RX_FIFO_DEPTH_LOG2 must be between 4 and 12"
+#endif
+
+#define FIFO_DEPTH_LOG2_MAX ((TX_FIFO_DEPTH_LOG2 > RX_FIFO_DEPTH_LOG2) ? \
+                             TX_FIFO_DEPTH_LOG2 : RX_FIFO_DEPTH_LOG2)
+
 // Defining the Sizes for the datapath
 #define DATA_W 9       // 9-bit datapath for UART 
 // Possibly DATA_W 9 for parity.
-#define ADDR_W 6       // Address width to address each byte location(40 of them) 
+#define ADDR_W (FIFO_DEPTH_LOG2_MAX + 2) // Covers both rings + registers (6 at 16/16)
+
+// Host bus: 0 = one DATA_W word per access, 1 = 32-bit bus where the
+// data port moves one byte per enabled lane, up to four per access
+// (override with -DUART_WIDE_BUS=1)
+#ifndef UART_WIDE_BUS
+#define UART_WIDE_BUS 0
+#endif
+
+#if UART_WIDE_BUS
+#define HOST_DATA_W 32
+#else
+#define HOST_DATA_W DATA_W
+#endif
+#define HOST_LANES 4   // Byte enables on the host bus
+
+// FIFO pointers carry one extra wrap bit so full and empty differ
+// without giving up a slot: empty when equal, full when only the
+// wrap bit differs
+#define TX_PTR_W (TX_FIFO_DEPTH_LOG2 + 1)
+#define RX_PTR_W (RX_FIFO_DEPTH_LOG2 + 1)
+
+// TX frame timestamp FIFO, one 32-bit stamp per entry. Stamps beyond the
+// depth are dropped and flagged (override with -DTS_FIFO_DEPTH_LOG2=n).
+// RX stamps are kept beside their RX ring entry instead.
+#ifndef TS_FIFO_DEPTH_LOG2
+#define TS_FIFO_DEPTH_LOG2 3
+#endif
+#define TS_FIFO_SIZE (1 << TS_FIFO_DEPTH_LOG2)
+#define TS_PTR_W (TS_FIFO_DEPTH_LOG2 + 1)
 
 // RAM and buffer sizes
-#define TX_BUFFER_SIZE 16    // 16 bytes transmit buffer
-#define RX_BUFFER_SIZE 16    // 16 bytes receive buffer
+#define TX_BUFFER_SIZE (1 << TX_FIFO_DEPTH_LOG2) // Transmit ring entries
+#define RX_BUFFER_SIZE (1 << RX_FIFO_DEPTH_LOG2) // Receive ring entries
+#define RX_ENTRY_W 12  // RX ring entry: data byte plus per-character tags
 #define CONFIG_REG_SIZE 6    // 6 bytes of configuration registers
 #define STATUS_REG_SIZE 2    // 2 bytes of status registers
-#define RAM_SIZE 40          // Total RAM: 40 bytes (TX + RX + Config + Status)
+#define EXT_REG_SIZE 18      // 18 bytes of extended registers (at most 24)
+#define REG_BANK_SIZE (CONFIG_REG_SIZE + STATUS_REG_SIZE + EXT_REG_SIZE)
+#define RAM_SIZE (TX_BUFFER_SIZE + RX_BUFFER_SIZE + REG_BANK_SIZE)
+
+// Memory map address definitions - TX ring, RX ring, then registers
+#define TX_BUFFER_START    0
+#define RX_BUFFER_START    (TX_BUFFER_START + TX_BUFFER_SIZE)
+#define CONFIG_REG_START   (RX_BUFFER_START + RX_BUFFER_SIZE)
+#define STATUS_REG_START   (CONFIG_REG_START + CONFIG_REG_SIZE)
+#define EXT_REG_START      (STATUS_REG_START + STATUS_REG_SIZE)
+
+// RX ring entry tag bits, set on the byte they describe
+#define RX_TAG_PARITY      8  // Parity error
+#define RX_TAG_FRAMING     9  // Framing error
+#define RX_TAG_BREAK       10 // Break condition
+#define RX_TAG_FRAME_END   11 // Last byte of a de-framed packet
+
+// Framing modes, FRAMING_CONTROL_REG bits 0-1 (TX) and 2-3 (RX)
+#define FRAMING_OFF        0
+#define FRAMING_SLIP       1  // RFC 1055: END 0xC0, ESC 0xDB
+
+// SLIP special characters
+#define SLIP_END           0xC0
+#define SLIP_ESC           0xDB
+#define SLIP_ESC_END       0xDC
+#define SLIP_ESC_ESC       0xDD
+
+// Frame check engine modes, CRC_CONTROL_REG bits 0-1
+#define CRC_MODE_OFF       0
+#define CRC_MODE_8         1  // CRC-8, poly 0x07, init 0x00
+#define CRC_MODE_16        2  // CRC-16-CCITT, poly 0x1021, init 0xFFFF
+#define CRC_MODE_32        3  // CRC-32, reflected poly 0xEDB88320, init/xorout 0xFFFFFFFF
+
+// Register bank index of a register address
+#define REG_INDEX(a)       ((a) - CONFIG_REG_START)
+
+// Configuration register addresses
+#define BAUD_RATE_LOW      (CONFIG_REG_START + 0) // Baud rate divisor (low byte)
+#define BAUD_RATE_HIGH     (CONFIG_REG_START + 1) // Baud rate divisor (high byte)
+#define LINE_CONTROL_REG   (CONFIG_REG_START + 2) // Line control register
+#define FIFO_CONTROL_REG   (CONFIG_REG_START + 3) // FIFO control register
+#define SCRATCH_REG1       (CONFIG_REG_START + 4) // Scratch register 1
+#define SCRATCH_REG2       (CONFIG_REG_START + 5) // Scratch register 2
+
+// Status register addresses
+#define LINE_STATUS_REG    (STATUS_REG_START + 0) // Line status register
+#define FIFO_STATUS_REG    (STATUS_REG_START + 1) // FIFO status register
+
+// Line status register bit definitions
+#define LSR_DATA_READY     0x01 // Bit 0: Data ready
+#define LSR_OVERRUN_ERROR  0x02 // Bit 1: Overrun error
+#define LSR_PARITY_ERROR   0x04 // Bit 2: Parity error
+#define LSR_FRAMING_ERROR  0x08 // Bit 3: Framing error
+#define LSR_BREAK_DETECT   0x10 // Bit 4: Break detect
+#define LSR_TX_EMPTY       0x20 // Bit 5: TX ring empty
+#define LSR_TX_IDLE        0x40 // Bit 6: TX ring and transmitter empty
+#define LSR_RX_FIFO_ERROR  0x80 // Bit 7: RX FIFO error
+#define LSR_FRAME_END      0x100 // Bit 8: Next RBR byte ends a de-framed packet
+
+// FIFO status register bit definitions
+#define FSR_TX_FULL        0x01 // Bit 0: TX buffer full
+#define FSR_RX_EMPTY       0x02 // Bit 1: RX buffer empty
+#define FSR_TX_ALMOST_FULL 0x04 // Bit 2: TX buffer almost full
+#define FSR_RX_ALMOST_EMPTY 0x08 // Bit 3: RX buffer almost empty
+#define FSR_TX_COUNT_MASK  0x70 // Bits 4-6: TX buffer count (0-7)
+#define FSR_RX_COUNT_MASK  0x80 // Bit 7: RX buffer count (0-7)
+#define FSR_RX_TIMEOUT     0x100 // Bit 8: RX character timeout
+
+// Interrupt identification register bit definitions
+#define IIR_ID_MASK        0x0F // Bits 0-3: Pending interrupt (1 = none)
+#define IIR_FIFOS_ENABLED  0xC0 // Bits 6-7: Set while FIFOs are enabled
+
+// Interrupt identification codes, highest priority first
+#define IIR_LINE_STATUS    0x06
+#define IIR_CHAR_MATCH     0x0A
+#define IIR_RX_DATA        0x04
+#define IIR_RX_TIMEOUT     0x0C
+#define IIR_TX_EMPTY       0x02
+#define IIR_NONE           0x01
+
+// Line control register bit definitions
+#define LCR_DATA_BITS_MASK 0x03 // Bits 0-1: Data bits (0=5, 1=6, 2=7, 3=8)
+#define LCR_STOP_BITS      0x04 // Bit 2: Stop bits (0=1, 1=2)
+#define LCR_PARITY_ENABLE  0x08 // Bit 3: Parity enable
+#define LCR_PARITY_EVEN    0x10 // Bit 4: Even parity when set, odd when clear
+#define LCR_STICK_PARITY   0x20 // Bit 5: Stick parity
+#define LCR_BREAK_CONTROL  0x40 // Bit 6: Break control
+#define LCR_DLAB           0x80 // Bit 7: Divisor latch access bit
+
+// FIFO control register bit definitions
+#define FCR_FIFO_ENABLE    0x01 // Bit 0: FIFO enable
+#define FCR_TX_TRIGGER_MASK 0x30 // Bits 4-5: TX low water (0=empty, 1=2, 2=4, 3=8)
+#define FCR_TX_TRIGGER_SHIFT 4
+#define FCR_RX_TRIGGER_MASK 0xC0 // Bits 6-7: RX trigger (0=1, 1=4, 2=8, 3=14)
+#define FCR_RX_TRIGGER_SHIFT 6
+
+// Receiver control register bit definitions
+#define RXC_OSR_MASK       0x03 // Bits 0-1: Oversampling (0=16x, 1=8x, 2=4x)
+#define RXC_AUTOBAUD_MASK  0x0C // Bits 2-3: Autobaud (0=off, 1=start bit, 2=0x55, 3='A'/'a')
+#define RXC_AUTOBAUD_SHIFT 2
+#define RXC_MULTIDROP      0x10 // Bit 4: 9-bit multidrop, parity slot is the address bit
+
+// Modem control register bit definitions
+#define MCR_RTS            0x02 // Bit 1: RTS level when auto flow is off
+#define MCR_AUTO_FLOW      0x20 // Bit 5: Auto-RTS / auto-CTS enable
+#define MCR_XON_XOFF       0x40 // Bit 6: In-band XON/XOFF flow control
+
+// In-band flow control characters
+#define XON_CHAR           0x11 // DC1
+#define XOFF_CHAR          0x13 // DC3
+
+// Interrupt enable register bit definitions
+#define IER_RX_DATA        0x01 // Bit 0: RX trigger level reached
+#define IER_TX_EMPTY       0x02 // Bit 1: TX ring at or below low water
+#define IER_LINE_STATUS    0x04 // Bit 2: Receive error
+#define IER_CHAR_MATCH     0x08 // Bit 3: Match character in the RX ring
+
+// RX bytes as the host sees them
+#define RBR_ERROR          0x100 // Bit 8: Byte carries an error tag, see LSR
+
+// Error tags of an RX entry, the frame-end tag is not an error
+#define RX_ENTRY_ERRORS(e) ((e).range(RX_TAG_BREAK, RX_TAG_PARITY))
+
+// RS-485 control register bit definitions
+#define RSC_DE_ENABLE      0x01 // Bit 0: Drive de_out from the transmitter
+#define RSC_ECHO_SUPPRESS  0x02 // Bit 1: Ignore rx_in while DE is asserted
+#define RSC_GUARD_MASK     0xF0 // Bits 4-7: DE hold after the stop bit, in bit periods
+#define RSC_GUARD_SHIFT    4
+
+// CRC control register bit definitions. The clear bits read as 0; on
+// the shadow port each toggles once per clear request.
+#define CRC_MODE_MASK      0x03 // Bits 0-1: CRC_MODE_OFF/8/16/32
+#define CRC_TX_CLEAR       0x04 // Bit 2: Restart the TX CRC
+#define CRC_RX_CLEAR       0x08 // Bit 3: Restart the RX CRC
+#define CRC_READ_RX        0x10 // Bit 4: CRC_DATA_REG reads the RX CRC
+#define CRC_BYTE_MASK      0x60 // Bits 5-6: CRC_DATA_REG byte, 0 = bits 7-0
+#define CRC_BYTE_SHIFT     5
+
+// Framing control register fields
+#define FRC_TX_MASK        0x03 // Bits 0-1: TX framing mode
+#define FRC_RX_MASK        0x0C // Bits 2-3: RX framing mode
+#define FRC_RX_SHIFT       2
+
+// Timestamp control register bit definitions
+#define TS_SELECT_TX       0x01 // Bit 0: Select the TX FIFO (0 = RX)
+#define TS_BYTE_MASK       0x06 // Bits 1-2: TS_DATA_REG byte, 0 = bits 7-0
+#define TS_BYTE_SHIFT      1
+#define TS_POP             0x08 // Bit 3: Pop the TX FIFO (reads as 0), RX pops with RBR
+#define TS_READY           0x10 // Bit 4: Selected FIFO holds a stamp (read-only)
+#define TS_OVERFLOW        0x20 // Bit 5: TX FIFO dropped a stamp (read-only)
+
+// Extended register addresses
+#define BAUD_RATE_FRAC     (EXT_REG_START + 0)    // Baud rate divisor fraction (1/256 steps)
+#define RX_CONTROL_REG     (EXT_REG_START + 1)    // Receiver control (oversampling, autobaud)
+#define MODEM_CONTROL_REG  (EXT_REG_START + 2)    // Modem control (RTS, auto flow control)
+#define RTS_THRESHOLD_REG  (EXT_REG_START + 3)    // RX fill level that drops auto-RTS
+#define INT_ENABLE_REG     (EXT_REG_START + 4)    // Interrupt enable
+#define INT_IDENT_REG      (EXT_REG_START + 5)    // Interrupt identification (read-only)
+#define DATA_PORT_REG      (EXT_REG_START + 6)    // Read pops RX ring (RBR), write pushes TX ring (THR)
+#define STATION_ADDR_REG   (EXT_REG_START + 7)    // Multidrop station address
+#define STATION_MASK_REG   (EXT_REG_START + 8)    // Multidrop address compare mask
+#define RS485_CONTROL_REG  (EXT_REG_START + 9)    // RS-485 driver enable, echo suppression, guard time
+#define CRC_CONTROL_REG    (EXT_REG_START + 10)   // CRC polynomial, clear, readback select
+#define CRC_DATA_REG       (EXT_REG_START + 11)   // Selected byte of the TX or RX CRC (read-only)
+#define FRAMING_CONTROL_REG (EXT_REG_START + 12)  // TX/RX byte-stuffing framer modes
+#define MATCH_CHAR_REG     (EXT_REG_START + 13)   // RX match character and enable
+#define MATCH_INDEX_REG    (EXT_REG_START + 14)   // Bytes up to the latched match (read-only)
+#define TS_CONTROL_REG     (EXT_REG_START + 15)   // Timestamp FIFO select, byte select, pop, status
+#define TS_DATA_REG        (EXT_REG_START + 16)   // Selected byte of the selected FIFO's head (read-only)
+#define RX_LANE_ERROR_REG  (EXT_REG_START + 17)   // Lanes of the last RBR read holding a tagged byte (read-only)
+
+// Reset value of RTS_THRESHOLD_REG: two entries short of full, capped
+// at what fits in a register
+#define RTS_THRESHOLD_DEFAULT ((RX_BUFFER_SIZE > 256) ? 256 : RX_BUFFER_SIZE - 2)
 
 // Number of nanoseconds in a cycle
 #define CYCLE_LENGTH 5
 
+// Protocol loop timing: 0 = two clocks per process() iteration,
+// 1 = one clock per iteration (override with -DUART_SINGLE_CYCLE=1).
+// Either way a bit period is divisor * oversampling iterations, so the
+// shortest bit is 4 iterations (divisor 1, 4x oversampling): the
+// controller acts on a tick an iteration after it and the datapath an
+// iteration after that, and both must finish inside the bit.
+#ifndef UART_SINGLE_CYCLE
+#define UART_SINGLE_CYCLE 0
+#endif
+
+// Core architecture: 0 = separate controller and datapath modules,
+// 1 = fused uart_core, FSM and datapath in one thread so control
+// decisions act in the same cycle (override with -DUART_FUSED_CORE=1)
+#ifndef UART_FUSED_CORE
+#define UART_FUSED_CORE 0
+#endif
+
 // FSM state constants
 #define TX_IDLE 0
 #define RX_IDLE 1
@@ -8,6 +8,9 @@
  *********************************************/
 
  #include "top.h"
+ 
+ // Modem control register bit definitions
+ #define MCR_LOOPBACK       0x10 // Bit 4: Internal loopback
 
  void top::process() {
    // Initial reset
@@ -40,6 +43,7 @@
        // Allow modules to process
        // They will read from their input ports
        // The modules' process methods are triggered by clock edges
+       route_serial();
      }
      
      // Output phase
@@ -55,11 +59,13 @@
        wait();
      }
      
+#if !UART_SINGLE_CYCLE
      // Additional wait for processing time
      {       
        HLS_DEFINE_PROTOCOL("wait");
        wait();
      }
+#endif
    }
  }
  
@@ -72,25 +78,101 @@
    in_read_write = read_write.read();
    in_write_enable = write_enable.read();
    in_rx_in = rx_in.read();
+   in_cts = cts.read();
+   in_loopback = (mem_to_dp_cfg_modem_control.read() & MCR_LOOPBACK) != 0;
+   in_dp_tx_out = dp_tx_out.read();
+   in_dp_rts_out = dp_rts_out.read();
+   in_dp_de_out = dp_de_out.read();
    
    // Set internal control signals
    start_signal.write(false);  // No external start in this implementation
-   mem_we_signal.write(in_write_enable);
+   
+   // Host writes go through the memory map's own port and the core
+   // reaches memory through its fetch and store ports, so a host write
+   // never needs to hold the core
+   mem_we_signal.write(false);
  }
  
  
  void top::write_outputs() {
-   // Write external outputs
-   data_out.write(memory_map_inst.data_out);
-   tx_out.write(datapath_inst.tx_out);
-   tx_buffer_full.write(datapath_inst.tx_buffer_full);
-   rx_buffer_empty.write(datapath_inst.rx_buffer_empty);
-   error_indicator.write(datapath_inst.parity_error || 
-                         datapath_inst.framing_error || 
-                         datapath_inst.overrun_error);
+   // Write external outputs. data_out is driven by the memory map
+   // directly, a second write here would race it with a stale value.
+   tx_buffer_full.write(dp_to_ctrl_tx_buffer_full.read());
+   rx_buffer_empty.write(dp_to_ctrl_rx_buffer_empty.read());
+   error_indicator.write(dp_to_ctrl_parity_error.read() || 
+                         dp_to_ctrl_framing_error.read() || 
+                         dp_to_ctrl_overrun_error.read());
+ }
+ 
+ 
+ // Serial line routing. In loopback the datapath's TX feeds its own
+ // receiver and RTS feeds CTS, so a self-test runs at full line rate
+ // with nothing attached. The pins are held at idle meanwhile: tx_out
+ // at mark, RTS deasserted so the far end does not send and the RS-485
+ // driver off.
+ void top::route_serial() {
+   if (in_loopback) {
+     dp_rx_in.write(in_dp_tx_out);
+     dp_cts_in.write(in_dp_rts_out);
+     tx_out.write(true);
+     rts.write(false);
+     de.write(false);
+   } else {
+     dp_rx_in.write(in_rx_in);
+     dp_cts_in.write(in_cts);
+     tx_out.write(in_dp_tx_out);
+     rts.write(in_dp_rts_out);
+     de.write(in_dp_de_out);
+   }
  }
  
  
+ #if UART_FUSED_CORE
+ bool top::test_reset_datapath() {
+   // Datapath registers live in the fused core
+   bool tx_reg_ok = (core_inst.tx_shift_register == 0);
+   bool rx_reg_ok = (core_inst.rx_shift_register == 0);
+   bool buffers_ok = (core_inst.tx_buf_head == 0) &&
+                     (core_inst.tx_buf_tail == 0) &&
+                     (core_inst.rx_buf_head == 0) &&
+                     (core_inst.rx_buf_tail == 0);
+   bool signals_ok = (core_inst.out_tx_out == 1) &&
+                     (core_inst.out_tx_buffer_full == false) &&
+                     (core_inst.out_rx_buffer_empty == true);
+   
+   if(!tx_reg_ok || !rx_reg_ok) {
+     std::cout << "Core shift registers not reset properly" << std::endl;
+     return false;
+   }
+   
+   if(!buffers_ok) {
+     std::cout << "Buffer pointers not reset properly" << std::endl;
+     return false;
+   }
+   
+   if(!signals_ok) {
+     std::cout << "Output signals not reset properly" << std::endl;
+     return false;
+   }
+   
+   return true;
+ }
+ 
+ bool top::test_reset_controller() {
+   // The fused core has a single TX frame state and no RX state
+   if(core_inst.tx_state != CORE_TX_IDLE) {
+     std::cout << "core_inst.tx_state - " << core_inst.tx_state << std::endl;
+     return false;
+   }
+   
+   if(core_inst.rx_sampling || core_inst.de_active) {
+     std::cout << "Core frame state not reset properly" << std::endl;
+     return false;
+   }
+   
+   return true;
+ }
+ #else
  bool top::test_reset_datapath() {
    // Check if datapath registers are reset properly
    bool tx_reg_ok = (datapath_inst.tx_shift_register == 0);
@@ -99,8 +181,6 @@
                      (datapath_inst.tx_buf_tail == 0) &&
                      (datapath_inst.rx_buf_head == 0) &&
                      (datapath_inst.rx_buf_tail == 0);
-   bool counters_ok = (datapath_inst.tx_bit_count == 0) &&
-                      (datapath_inst.rx_bit_count == 0);
    bool signals_ok = (datapath_inst.out_tx_out == 1) &&
                      (datapath_inst.out_tx_buffer_full == false) &&
                      (datapath_inst.out_rx_buffer_empty == true);
@@ -120,11 +200,6 @@
      return false;
    }
    
-   if(!counters_ok) {
-     std::cout << "Bit counters not reset properly" << std::endl;
-     return false;
-   }
-   
    if(!signals_ok) {
      std::cout << "Output signals not reset properly" << std::endl;
      return false;
@@ -135,22 +210,22 @@
  
  bool top::test_reset_controller() {
    // Check if controller state is properly reset
-   if(controller_inst.tx_state != TX_IDLE) {
+   if(controller_inst.tx_state != controller::CTRL_TX_IDLE) {
      std::cout << "controller_inst.tx_state - " << controller_inst.tx_state << std::endl;
      return false;
    }
    
-   if(controller_inst.rx_state != RX_IDLE) {
+   if(controller_inst.rx_state != controller::CTRL_RX_IDLE) {
      std::cout << "controller_inst.rx_state - " << controller_inst.rx_state << std::endl;
      return false;
    }
    
-   if(controller_inst.tx_next_state != TX_IDLE) {
+   if(controller_inst.tx_next_state != controller::CTRL_TX_IDLE) {
      std::cout << "controller_inst.tx_next_state - " << controller_inst.tx_next_state << std::endl;
      return false;
    }
    
-   if(controller_inst.rx_next_state != RX_IDLE) {
+   if(controller_inst.rx_next_state != controller::CTRL_RX_IDLE) {
      std::cout << "controller_inst.rx_next_state - " << controller_inst.rx_next_state << std::endl;
      return false;
    }
@@ -165,9 +240,7 @@
       controller_inst.out_rx_start ||
       controller_inst.out_rx_data ||
       controller_inst.out_rx_parity ||
-      controller_inst.out_rx_stop ||
-      controller_inst.out_rx_read ||
-      controller_inst.out_error_handle) {
+      controller_inst.out_rx_stop) {
      
      std::cout << "Controller outputs not reset properly" << std::endl;
      return false;
@@ -175,12 +248,19 @@
    
    return true;
  }
+ #endif
  
  bool top::test_reset_memory_map() {
-   // Verify memory map is properly reset
-   for (int i = 0; i < RAM_SIZE; i++) {
-     if (memory_map_inst.Memory[i] != 0) {
-       std::cout << "Memory[" << i << "] is not reset, equals " << memory_map_inst.Memory[i] << std::endl;
+   // Verify both ring banks are cleared by reset
+   for (int i = 0; i < TX_BUFFER_SIZE; i++) {
+     if (memory_map_inst.TxBank[i] != 0) {
+       std::cout << "TxBank[" << i << "] is not reset, equals " << memory_map_inst.TxBank[i] << std::endl;
+       return false;
+     }
+   }
+   for (int i = 0; i < RX_BUFFER_SIZE; i++) {
+     if (memory_map_inst.RxBank[i] != 0) {
+       std::cout << "RxBank[" << i << "] is not reset, equals " << memory_map_inst.RxBank[i] << std::endl;
        return false;
      }
    }
@@ -12,35 +12,51 @@
  #include "systemc.h"
  #include "stratus_hls.h"
  #include "sizes.h"
+ #if UART_FUSED_CORE
+ #include "uart_core.h"
+ #else
  #include "datapath.h"
  #include "controller.h"
+ #endif
  #include "memory_map.h"
  
  SC_MODULE(top) {
    // Inputs from testbench
    sc_in<bool> clk;                        // Port 0
    sc_in<bool> rst;                        // Port 1
-   sc_in<sc_uint<DATA_W>> data_in;         // Port 2
+   sc_in<sc_uint<HOST_DATA_W>> data_in;    // Port 2
    sc_in<sc_uint<ADDR_W>> addr;            // Port 3
    sc_in<bool> chip_select;                // Port 4
    sc_in<bool> read_write;                 // Port 5
    sc_in<bool> write_enable;               // Port 6
-   sc_in<bool> rx_in;                      // Port 7
+   sc_in<sc_uint<HOST_LANES>> byte_enable; // Port 7 - Data port lanes (wide bus)
+   sc_in<bool> burst;                      // Port 8 - Auto-increment burst
+   sc_in<bool> rx_in;                      // Port 9
+   sc_in<bool> cts;                        // Port 10 - Clear to send
  
    // Outputs to testbench
-   sc_out<sc_uint<DATA_W>> data_out;       // Port 8
-   sc_out<bool> tx_out;                    // Port 9
-   sc_out<bool> tx_buffer_full;            // Port 10
-   sc_out<bool> rx_buffer_empty;           // Port 11
-   sc_out<bool> error_indicator;           // Port 12
+   sc_out<sc_uint<HOST_DATA_W>> data_out;  // Port 11
+   sc_out<sc_uint<HOST_LANES>> byte_valid; // Port 12 - Lanes filled by a pop
+   sc_out<bool> tx_out;                    // Port 13
+   sc_out<bool> rts;                       // Port 14 - Request to send
+   sc_out<bool> de;                        // Port 15 - RS-485 driver enable
+   sc_out<bool> tx_buffer_full;            // Port 16
+   sc_out<bool> rx_buffer_empty;           // Port 17
+   sc_out<bool> error_indicator;           // Port 18
+   sc_out<bool> irq;                       // Port 19 - Interrupt request
  
    // Submodules
+ #if UART_FUSED_CORE
+   uart_core core_inst;
+ #else
    datapath datapath_inst;
    controller controller_inst;
+ #endif
    memory_map memory_map_inst;
  
    // Internal signals for connecting modules
    
+ #if !UART_FUSED_CORE
    // Controller to datapath signals
    sc_signal<bool> ctrl_to_dp_load_tx;
    sc_signal<bool> ctrl_to_dp_load_tx2;
@@ -52,29 +68,79 @@
    sc_signal<bool> ctrl_to_dp_rx_data;
    sc_signal<bool> ctrl_to_dp_rx_parity;
    sc_signal<bool> ctrl_to_dp_rx_stop;
-   sc_signal<bool> ctrl_to_dp_error_handle;
-   sc_signal<bool> ctrl_to_dp_rx_read;
+   sc_signal<bool> ctrl_to_dp_de;
+   sc_signal<bool> ctrl_to_dp_tx_end;
    
    // Datapath to controller signals
-   sc_signal<bool> dp_to_ctrl_tx_buffer_full;
-   sc_signal<bool> dp_to_ctrl_rx_buffer_empty;
-   sc_signal<bool> dp_to_ctrl_parity_error;
-   sc_signal<bool> dp_to_ctrl_framing_error;
-   sc_signal<bool> dp_to_ctrl_overrun_error;
+   sc_signal<bool> dp_to_ctrl_tx_ready;
+   sc_signal<bool> dp_to_ctrl_tx_buffer_empty;
+   sc_signal<bool> dp_to_ctrl_cts;
+   sc_signal<bool> dp_to_ctrl_tx_tick;
+   sc_signal<bool> dp_to_ctrl_rx_tick;
+   sc_signal<bool> dp_to_ctrl_rx_bit;
    
    // Configuration signals
    sc_signal<bool> dp_to_ctrl_parity_enabled;
    sc_signal<bool> dp_to_ctrl_parity_even;
-   sc_signal<sc_uint<3>> dp_to_ctrl_data_bits;
+   sc_signal<sc_uint<4>> dp_to_ctrl_data_bits;
    sc_signal<sc_uint<2>> dp_to_ctrl_stop_bits;
+   sc_signal<sc_uint<4>> dp_to_ctrl_de_guard;
+ #endif
+   
+   // Status from the core, also read by write_outputs
+   sc_signal<bool> dp_to_ctrl_tx_buffer_full;
+   sc_signal<bool> dp_to_ctrl_rx_buffer_empty;
+   sc_signal<bool> dp_to_ctrl_parity_error;
+   sc_signal<bool> dp_to_ctrl_framing_error;
+   sc_signal<bool> dp_to_ctrl_overrun_error;
    
    // Memory map to datapath signals
    sc_signal<sc_uint<DATA_W>> mem_to_dp_data;
    
    // Datapath to memory map signals
-   sc_signal<sc_uint<DATA_W>> dp_to_mem_data;
+   sc_signal<sc_uint<RX_ENTRY_W>> dp_to_mem_wdata;
    sc_signal<sc_uint<ADDR_W>> dp_to_mem_addr;
+   sc_signal<sc_uint<ADDR_W>> dp_to_mem_tx_fetch_addr;
    sc_signal<bool> dp_to_mem_write_enable;
+   sc_signal<sc_uint<4>> dp_to_mem_int_id;
+   sc_signal<bool> dp_to_mem_rx_timeout;
+   sc_signal<bool> dp_to_mem_match_pending;
+   sc_signal<sc_uint<RX_PTR_W>> dp_to_mem_match_index;
+   sc_signal<sc_uint<32>> dp_to_mem_ts_data;
+   sc_signal<bool> dp_to_mem_ts_tx_event;
+   sc_signal<bool> dp_to_mem_tx_idle;
+   sc_signal<sc_uint<32>> mem_to_dp_ts_count;
+   sc_signal<sc_uint<32>> dp_to_mem_tx_crc;
+   sc_signal<sc_uint<32>> dp_to_mem_rx_crc;
+   
+   // Configuration shadows from memory map to datapath
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_line_control;
+   sc_signal<sc_uint<16>> mem_to_dp_cfg_baud_divisor;
+   sc_signal<sc_uint<8>> mem_to_dp_cfg_baud_fraction;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_fifo_control;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_rx_control;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_modem_control;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_rts_threshold;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_int_enable;
+   sc_signal<sc_uint<16>> mem_to_dp_cfg_station;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_rs485_control;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_crc_control;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_framing_control;
+   sc_signal<sc_uint<DATA_W>> mem_to_dp_cfg_match_char;
+   
+   // Ring pointers between datapath and memory map
+   sc_signal<sc_uint<TX_PTR_W>> mem_to_dp_tx_head;
+   sc_signal<sc_uint<RX_PTR_W>> mem_to_dp_rx_tail;
+   sc_signal<sc_uint<TX_PTR_W>> dp_to_mem_tx_tail;
+   sc_signal<sc_uint<RX_PTR_W>> dp_to_mem_rx_head;
+   
+   // Serial and modem lines between the pins and the datapath,
+   // routed through top so loopback can turn them around
+   sc_signal<bool> dp_rx_in;
+   sc_signal<bool> dp_tx_out;
+   sc_signal<bool> dp_cts_in;
+   sc_signal<bool> dp_rts_out;
+   sc_signal<bool> dp_de_out;
    
    // Internal signals for start and memory write enable
    sc_signal<bool> start_signal;
@@ -82,32 +148,93 @@
    
    // Internal input values
    bool in_rst;
-   sc_uint<DATA_W> in_data_in;
+   sc_uint<HOST_DATA_W> in_data_in;
    sc_uint<ADDR_W> in_addr;
    bool in_chip_select;
    bool in_read_write;
    bool in_write_enable;
    bool in_rx_in;
+   bool in_cts;
    bool in_start;
    bool in_mem_we;
+   bool in_loopback;
+   bool in_dp_tx_out;
+   bool in_dp_rts_out;
+   bool in_dp_de_out;
  
    // Top-level methods
    void process();
    void read_inputs();
    void write_outputs();
+   void route_serial();
  
    // Test methods
    bool test_reset_datapath();
    bool test_reset_controller();
    bool test_reset_memory_map();
  
-   SC_CTOR(top) : datapath_inst("datapath_inst"), 
+   SC_CTOR(top) :
+ #if UART_FUSED_CORE
+                 core_inst("core_inst"), 
+ #else
+                 datapath_inst("datapath_inst"), 
                  controller_inst("controller_inst"), 
+ #endif
                  memory_map_inst("memory_map_inst") {
      SC_THREAD(process);
      sensitive << clk.pos();
      async_reset_signal_is(rst, false);
  
+ #if UART_FUSED_CORE
+     // Connect all the fused core signals
+     core_inst.clk(clk);
+     core_inst.rst(rst);
+     core_inst.tx_buffer_full(dp_to_ctrl_tx_buffer_full);
+     core_inst.rx_buffer_empty(dp_to_ctrl_rx_buffer_empty);
+     core_inst.parity_error(dp_to_ctrl_parity_error);
+     core_inst.framing_error(dp_to_ctrl_framing_error);
+     core_inst.overrun_error(dp_to_ctrl_overrun_error);
+     core_inst.rx_timeout(dp_to_mem_rx_timeout);
+     core_inst.irq(irq);
+     core_inst.int_id(dp_to_mem_int_id);
+     core_inst.match_pending(dp_to_mem_match_pending);
+     core_inst.match_index(dp_to_mem_match_index);
+     core_inst.ts_tx_event(dp_to_mem_ts_tx_event);
+     core_inst.tx_idle(dp_to_mem_tx_idle);
+     core_inst.rx_in(dp_rx_in);
+     core_inst.tx_out(dp_tx_out);
+     core_inst.cts_in(dp_cts_in);
+     core_inst.rts_out(dp_rts_out);
+     core_inst.de_out(dp_de_out);
+     core_inst.data_in(mem_to_dp_data);
+     core_inst.addr(dp_to_mem_tx_fetch_addr);
+     core_inst.dp_data_in(dp_to_mem_wdata);
+     core_inst.dp_addr(dp_to_mem_addr);
+     core_inst.dp_write_enable(dp_to_mem_write_enable);
+     core_inst.dp_ts_data(dp_to_mem_ts_data);
+     core_inst.ts_count(mem_to_dp_ts_count);
+     core_inst.tx_crc(dp_to_mem_tx_crc);
+     core_inst.rx_crc(dp_to_mem_rx_crc);
+     core_inst.cfg_line_control(mem_to_dp_cfg_line_control);
+     core_inst.cfg_baud_divisor(mem_to_dp_cfg_baud_divisor);
+     core_inst.cfg_baud_fraction(mem_to_dp_cfg_baud_fraction);
+     core_inst.cfg_fifo_control(mem_to_dp_cfg_fifo_control);
+     core_inst.cfg_rx_control(mem_to_dp_cfg_rx_control);
+     core_inst.cfg_modem_control(mem_to_dp_cfg_modem_control);
+     core_inst.cfg_rts_threshold(mem_to_dp_cfg_rts_threshold);
+     core_inst.cfg_int_enable(mem_to_dp_cfg_int_enable);
+     core_inst.cfg_station(mem_to_dp_cfg_station);
+     core_inst.cfg_rs485_control(mem_to_dp_cfg_rs485_control);
+     core_inst.cfg_crc_control(mem_to_dp_cfg_crc_control);
+     core_inst.cfg_framing_control(mem_to_dp_cfg_framing_control);
+     core_inst.cfg_match_char(mem_to_dp_cfg_match_char);
+     core_inst.tx_head(mem_to_dp_tx_head);
+     core_inst.rx_tail(mem_to_dp_rx_tail);
+     core_inst.tx_tail(dp_to_mem_tx_tail);
+     core_inst.rx_head(dp_to_mem_rx_head);
+     core_inst.start(start_signal);
+     core_inst.mem_we(mem_we_signal);
+ #else
      // Connect all the Datapath Signals
      datapath_inst.clk(clk);
      datapath_inst.rst(rst);
@@ -121,25 +248,62 @@
      datapath_inst.rx_data(ctrl_to_dp_rx_data);
      datapath_inst.rx_parity(ctrl_to_dp_rx_parity);
      datapath_inst.rx_stop(ctrl_to_dp_rx_stop);
-     datapath_inst.error_handle(ctrl_to_dp_error_handle);
-     datapath_inst.rx_read(ctrl_to_dp_rx_read);
+     datapath_inst.de(ctrl_to_dp_de);
+     datapath_inst.tx_end(ctrl_to_dp_tx_end);
      datapath_inst.tx_buffer_full(dp_to_ctrl_tx_buffer_full);
+     datapath_inst.tx_buffer_empty(dp_to_ctrl_tx_buffer_empty);
      datapath_inst.rx_buffer_empty(dp_to_ctrl_rx_buffer_empty);
      datapath_inst.parity_error(dp_to_ctrl_parity_error);
      datapath_inst.framing_error(dp_to_ctrl_framing_error);
      datapath_inst.overrun_error(dp_to_ctrl_overrun_error);
+     datapath_inst.tx_ready(dp_to_ctrl_tx_ready);
+     datapath_inst.tx_tick(dp_to_ctrl_tx_tick);
+     datapath_inst.rx_tick(dp_to_ctrl_rx_tick);
+     datapath_inst.rx_bit(dp_to_ctrl_rx_bit);
+     datapath_inst.cts(dp_to_ctrl_cts);
+     datapath_inst.rx_timeout(dp_to_mem_rx_timeout);
+     datapath_inst.irq(irq);
+     datapath_inst.int_id(dp_to_mem_int_id);
+     datapath_inst.match_pending(dp_to_mem_match_pending);
+     datapath_inst.match_index(dp_to_mem_match_index);
+     datapath_inst.ts_tx_event(dp_to_mem_ts_tx_event);
+     datapath_inst.tx_idle(dp_to_mem_tx_idle);
      datapath_inst.ctrl_parity_enabled(dp_to_ctrl_parity_enabled);
      datapath_inst.ctrl_parity_even(dp_to_ctrl_parity_even);
      datapath_inst.ctrl_data_bits(dp_to_ctrl_data_bits);
      datapath_inst.ctrl_stop_bits(dp_to_ctrl_stop_bits);
-     datapath_inst.rx_in(rx_in);
-     datapath_inst.tx_out(tx_out);
+     datapath_inst.ctrl_de_guard(dp_to_ctrl_de_guard);
+     datapath_inst.rx_in(dp_rx_in);
+     datapath_inst.tx_out(dp_tx_out);
+     datapath_inst.cts_in(dp_cts_in);
+     datapath_inst.rts_out(dp_rts_out);
+     datapath_inst.de_out(dp_de_out);
      datapath_inst.data_in(mem_to_dp_data);
-     datapath_inst.data_out(dp_to_mem_data);
-     datapath_inst.addr(dp_to_mem_addr);
-     datapath_inst.dp_data_in(dp_to_mem_data);
+     datapath_inst.addr(dp_to_mem_tx_fetch_addr);
+     datapath_inst.dp_data_in(dp_to_mem_wdata);
      datapath_inst.dp_addr(dp_to_mem_addr);
      datapath_inst.dp_write_enable(dp_to_mem_write_enable);
+     datapath_inst.dp_ts_data(dp_to_mem_ts_data);
+     datapath_inst.ts_count(mem_to_dp_ts_count);
+     datapath_inst.tx_crc(dp_to_mem_tx_crc);
+     datapath_inst.rx_crc(dp_to_mem_rx_crc);
+     datapath_inst.tx_head(mem_to_dp_tx_head);
+     datapath_inst.rx_tail(mem_to_dp_rx_tail);
+     datapath_inst.tx_tail(dp_to_mem_tx_tail);
+     datapath_inst.rx_head(dp_to_mem_rx_head);
+     datapath_inst.cfg_line_control(mem_to_dp_cfg_line_control);
+     datapath_inst.cfg_baud_divisor(mem_to_dp_cfg_baud_divisor);
+     datapath_inst.cfg_baud_fraction(mem_to_dp_cfg_baud_fraction);
+     datapath_inst.cfg_fifo_control(mem_to_dp_cfg_fifo_control);
+     datapath_inst.cfg_rx_control(mem_to_dp_cfg_rx_control);
+     datapath_inst.cfg_modem_control(mem_to_dp_cfg_modem_control);
+     datapath_inst.cfg_rts_threshold(mem_to_dp_cfg_rts_threshold);
+     datapath_inst.cfg_int_enable(mem_to_dp_cfg_int_enable);
+     datapath_inst.cfg_station(mem_to_dp_cfg_station);
+     datapath_inst.cfg_rs485_control(mem_to_dp_cfg_rs485_control);
+     datapath_inst.cfg_crc_control(mem_to_dp_cfg_crc_control);
+     datapath_inst.cfg_framing_control(mem_to_dp_cfg_framing_control);
+     datapath_inst.cfg_match_char(mem_to_dp_cfg_match_char);
      datapath_inst.start(start_signal);
      datapath_inst.mem_we(mem_we_signal);
      
@@ -149,8 +313,14 @@
      controller_inst.start(start_signal);
      controller_inst.mem_we(mem_we_signal);
      controller_inst.tx_buffer_full(dp_to_ctrl_tx_buffer_full);
+     controller_inst.tx_buffer_empty(dp_to_ctrl_tx_buffer_empty);
      controller_inst.rx_buffer_empty(dp_to_ctrl_rx_buffer_empty);
-     controller_inst.rx_in(rx_in);
+     controller_inst.tx_ready(dp_to_ctrl_tx_ready);
+     controller_inst.tx_tick(dp_to_ctrl_tx_tick);
+     controller_inst.rx_tick(dp_to_ctrl_rx_tick);
+     controller_inst.rx_bit(dp_to_ctrl_rx_bit);
+     controller_inst.rx_in(dp_rx_in);
+     controller_inst.cts(dp_to_ctrl_cts);
      controller_inst.parity_error(dp_to_ctrl_parity_error);
      controller_inst.framing_error(dp_to_ctrl_framing_error);
      controller_inst.overrun_error(dp_to_ctrl_overrun_error);
@@ -158,6 +328,7 @@
      controller_inst.parity_even(dp_to_ctrl_parity_even);
      controller_inst.data_bits(dp_to_ctrl_data_bits);
      controller_inst.stop_bits(dp_to_ctrl_stop_bits);
+     controller_inst.de_guard(dp_to_ctrl_de_guard);
      controller_inst.load_tx(ctrl_to_dp_load_tx);
      controller_inst.load_tx2(ctrl_to_dp_load_tx2);
      controller_inst.tx_start(ctrl_to_dp_tx_start);
@@ -168,8 +339,9 @@
      controller_inst.rx_data(ctrl_to_dp_rx_data);
      controller_inst.rx_parity(ctrl_to_dp_rx_parity);
      controller_inst.rx_stop(ctrl_to_dp_rx_stop);
-     controller_inst.rx_read(ctrl_to_dp_rx_read);
-     controller_inst.error_handle(ctrl_to_dp_error_handle);
+     controller_inst.de(ctrl_to_dp_de);
+     controller_inst.tx_end(ctrl_to_dp_tx_end);
+ #endif
      
      // Connect all the Memory Map signals
      memory_map_inst.clk(clk);
@@ -180,13 +352,44 @@
      memory_map_inst.chip_select(chip_select);
      memory_map_inst.read_write(read_write);
      memory_map_inst.write_enable(write_enable);
+     memory_map_inst.byte_enable(byte_enable);
+     memory_map_inst.burst(burst);
+     memory_map_inst.byte_valid(byte_valid);
      memory_map_inst.dp_data_out(mem_to_dp_data);
-     memory_map_inst.dp_data_in(dp_to_mem_data);
+     memory_map_inst.dp_data_in(dp_to_mem_wdata);
      memory_map_inst.dp_addr(dp_to_mem_addr);
      memory_map_inst.dp_write_enable(dp_to_mem_write_enable);
+     memory_map_inst.dp_ts_data(dp_to_mem_ts_data);
+     memory_map_inst.ts_count(mem_to_dp_ts_count);
+     memory_map_inst.tx_fetch_addr(dp_to_mem_tx_fetch_addr);
      memory_map_inst.tx_buffer_full(dp_to_ctrl_tx_buffer_full);
      memory_map_inst.rx_buffer_empty(dp_to_ctrl_rx_buffer_empty);
      memory_map_inst.error_indicator(error_indicator);
+     memory_map_inst.int_id(dp_to_mem_int_id);
+     memory_map_inst.rx_timeout(dp_to_mem_rx_timeout);
+     memory_map_inst.match_pending(dp_to_mem_match_pending);
+     memory_map_inst.match_index(dp_to_mem_match_index);
+     memory_map_inst.ts_tx_event(dp_to_mem_ts_tx_event);
+     memory_map_inst.tx_idle(dp_to_mem_tx_idle);
+     memory_map_inst.tx_crc(dp_to_mem_tx_crc);
+     memory_map_inst.rx_crc(dp_to_mem_rx_crc);
+     memory_map_inst.tx_head(mem_to_dp_tx_head);
+     memory_map_inst.rx_tail(mem_to_dp_rx_tail);
+     memory_map_inst.tx_tail(dp_to_mem_tx_tail);
+     memory_map_inst.rx_head(dp_to_mem_rx_head);
+     memory_map_inst.cfg_line_control(mem_to_dp_cfg_line_control);
+     memory_map_inst.cfg_baud_divisor(mem_to_dp_cfg_baud_divisor);
+     memory_map_inst.cfg_baud_fraction(mem_to_dp_cfg_baud_fraction);
+     memory_map_inst.cfg_fifo_control(mem_to_dp_cfg_fifo_control);
+     memory_map_inst.cfg_rx_control(mem_to_dp_cfg_rx_control);
+     memory_map_inst.cfg_modem_control(mem_to_dp_cfg_modem_control);
+     memory_map_inst.cfg_rts_threshold(mem_to_dp_cfg_rts_threshold);
+     memory_map_inst.cfg_int_enable(mem_to_dp_cfg_int_enable);
+     memory_map_inst.cfg_station(mem_to_dp_cfg_station);
+     memory_map_inst.cfg_rs485_control(mem_to_dp_cfg_rs485_control);
+     memory_map_inst.cfg_crc_control(mem_to_dp_cfg_crc_control);
+     memory_map_inst.cfg_framing_control(mem_to_dp_cfg_framing_control);
+     memory_map_inst.cfg_match_char(mem_to_dp_cfg_match_char);
    }
    
  #ifdef NC_SYSTEMC
@@ -202,14 +405,21 @@
      ncsc_replace_name(chip_select, "chip_select");      // Port 4
      ncsc_replace_name(read_write, "read_write");        // Port 5
      ncsc_replace_name(write_enable, "write_enable");    // Port 6
-     ncsc_replace_name(rx_in, "rx_in");                  // Port 7
+     ncsc_replace_name(byte_enable, "byte_enable");      // Port 7
+     ncsc_replace_name(burst, "burst");                  // Port 8
+     ncsc_replace_name(rx_in, "rx_in");                  // Port 9
+     ncsc_replace_name(cts, "cts");                      // Port 10
      
      // Outputs
-     ncsc_replace_name(data_out, "data_out");            // Port 8
-     ncsc_replace_name(tx_out, "tx_out");                // Port 9
-     ncsc_replace_name(tx_buffer_full, "tx_buffer_full");// Port 10
-     ncsc_replace_name(rx_buffer_empty, "rx_buffer_empty");// Port 11
-     ncsc_replace_name(error_indicator, "error_indicator");// Port 12
+     ncsc_replace_name(data_out, "data_out");            // Port 11
+     ncsc_replace_name(byte_valid, "byte_valid");        // Port 12
+     ncsc_replace_name(tx_out, "tx_out");                // Port 13
+     ncsc_replace_name(rts, "rts");                      // Port 14
+     ncsc_replace_name(de, "de");                        // Port 15
+     ncsc_replace_name(tx_buffer_full, "tx_buffer_full");// Port 16
+     ncsc_replace_name(rx_buffer_empty, "rx_buffer_empty");// Port 17
+     ncsc_replace_name(error_indicator, "error_indicator");// Port 18
+     ncsc_replace_name(irq, "irq");                      // Port 19
    }
  #endif
  };
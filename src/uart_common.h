@@ -0,0 +1,230 @@
+/**************************************************************
+ * File Name: uart_common.h
+ * Authors: Luke Guenthner, Nguyen Nguyen, Marcellus Wilson
+ * Date: 10/16/2026
+ *
+ * Combinational helpers shared by the split datapath and the
+ * fused uart_core, so both architectures run the same CRC, SLIP,
+ * sample vote, interrupt priority, flow control and autobaud
+ * arithmetic. Each one is pure: registers stay in the modules and
+ * are passed in by reference where a helper advances them.
+ **************************************************************/
+
+#ifndef __UART_COMMON_H__
+#define __UART_COMMON_H__
+
+#include "systemc.h"
+#include "sizes.h"
+
+// CRC polynomials
+#define CRC8_POLY          0x07
+#define CRC16_POLY         0x1021
+#define CRC32_POLY         0xEDB88320 // Reflected
+
+// Autobaud detector states
+#define AB_OFF             0
+#define AB_WAIT_EDGE       1
+#define AB_MEASURE         2
+#define AB_WRITEBACK       3
+#define AB_DONE            4
+
+// Frame check engine. Each call folds one byte into the running CRC;
+// the bit loop has a fixed count and unrolls into an XOR network, so a
+// byte costs one cycle. CRC-8 and CRC-16 shift MSB first, CRC-32 is the
+// reflected form used by Ethernet and zlib.
+inline sc_uint<32> crc_seed(sc_uint<2> mode) {
+    switch (mode) {
+        case CRC_MODE_16: return 0xFFFF;
+        case CRC_MODE_32: return 0xFFFFFFFF;
+        default:          return 0;
+    }
+}
+
+inline sc_uint<32> crc_update(sc_uint<32> crc, sc_uint<8> data, sc_uint<2> mode) {
+    for (int i = 0; i < 8; i++) {
+        bool feedback;
+
+        switch (mode) {
+            case CRC_MODE_8:
+                feedback = crc[7] ^ data[7 - i];
+                crc = (crc << 1) & 0xFF;
+                if (feedback) {
+                    crc ^= CRC8_POLY;
+                }
+                break;
+            case CRC_MODE_16:
+                feedback = crc[15] ^ data[7 - i];
+                crc = (crc << 1) & 0xFFFF;
+                if (feedback) {
+                    crc ^= CRC16_POLY;
+                }
+                break;
+            case CRC_MODE_32:
+                feedback = crc[0] ^ data[i];
+                crc = crc >> 1;
+                if (feedback) {
+                    crc ^= CRC32_POLY;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return crc;
+}
+
+// CRC as the host reads it, CRC-32 is inverted on the way out
+inline sc_uint<32> crc_result(sc_uint<32> crc, sc_uint<2> mode) {
+    return (mode == CRC_MODE_32) ? (sc_uint<32>)~crc : crc;
+}
+
+// Majority of the three samples around the middle of a bit
+inline bool sample_vote(sc_uint<3> samples) {
+    return (samples[0] & samples[1]) |
+           (samples[0] & samples[2]) |
+           (samples[1] & samples[2]);
+}
+
+// SLIP escape for one payload byte: the code that has to follow an ESC,
+// or 0 when the byte goes out as is
+inline sc_uint<8> slip_escape(sc_uint<8> byte) {
+    if (byte == SLIP_END) {
+        return SLIP_ESC_END;
+    } else if (byte == SLIP_ESC) {
+        return SLIP_ESC_ESC;
+    }
+    return 0;
+}
+
+// SLIP de-framer, one received character. END and ESC are consumed.
+// Each decoded byte waits in the stage until the next character shows
+// whether it ends the packet, and END hands it out tagged as the frame
+// end. A break aborts the packet in progress. entry and stamp come in
+// as the received character's and go out as the ring's; returns true
+// when they hold a byte to store. Empty packets (END END) store
+// nothing, and unknown escapes pass through as is, per RFC 1055.
+inline bool slip_decode(sc_uint<8> data, sc_uint<3> tags, sc_uint<32> frame_stamp,
+                        bool& escape, bool& staged,
+                        sc_uint<RX_ENTRY_W>& stage, sc_uint<32>& stage_stamp,
+                        sc_uint<RX_ENTRY_W>& entry, sc_uint<32>& stamp) {
+    if (tags[RX_TAG_BREAK - 8]) {
+        escape = false;
+        staged = false;
+        return true;
+    }
+
+    if (!escape && data == SLIP_END) {
+        bool store = staged;
+        entry = stage;
+        entry[RX_TAG_FRAME_END] = 1;
+        stamp = stage_stamp;
+        staged = false;
+        return store;
+    }
+
+    if (!escape && data == SLIP_ESC) {
+        escape = true;
+        return false;
+    }
+
+    if (escape && data == SLIP_ESC_END) {
+        data = SLIP_END;
+    } else if (escape && data == SLIP_ESC_ESC) {
+        data = SLIP_ESC;
+    }
+    escape = false;
+
+    bool store = staged;
+    entry = stage;
+    stamp = stage_stamp;
+    stage = data;
+    stage.range(RX_ENTRY_W - 1, 8) = tags;
+    stage_stamp = frame_stamp;
+    staged = true;
+    return store;
+}
+
+// An intact character that is in-band flow control, not data
+inline bool is_flow_char(sc_uint<8> data) {
+    return data == XON_CHAR || data == XOFF_CHAR;
+}
+
+// In-band flow control, TX half. Each change of the receiver's XOFF
+// request queues one XOFF or XON ahead of the TX ring. Turning the mode
+// off drops a queued character.
+inline void queue_flow_char(bool enabled, bool xoff_wanted,
+                            sc_uint<8>& flow_char, bool& xoff_sent) {
+    if (!enabled) {
+        flow_char = 0;
+        xoff_sent = false;
+    } else if (flow_char == 0 && xoff_wanted != xoff_sent) {
+        xoff_sent = xoff_wanted;
+        flow_char = xoff_wanted ? XOFF_CHAR : XON_CHAR;
+    }
+}
+
+// Interrupt identification. Trigger levels come from FIFO_CONTROL_REG;
+// with the FIFOs disabled the RX trigger is one byte and TX low water is
+// empty, as on a 16450. The code is the highest priority enabled source.
+inline sc_uint<4> interrupt_id(sc_uint<DATA_W> int_enable, sc_uint<DATA_W> fifo_control,
+                               bool line_status, bool match_pending, bool rx_timeout,
+                               sc_uint<RX_PTR_W> rx_fill, sc_uint<TX_PTR_W> tx_fill) {
+    sc_uint<4> rx_trigger = 1;
+    sc_uint<4> tx_low_water = 0;
+
+    if ((fifo_control & FCR_FIFO_ENABLE) != 0) {
+        switch ((fifo_control & FCR_RX_TRIGGER_MASK) >> FCR_RX_TRIGGER_SHIFT) {
+            case 1:  rx_trigger = 4;  break;
+            case 2:  rx_trigger = 8;  break;
+            case 3:  rx_trigger = 14; break;
+            default: rx_trigger = 1;  break;
+        }
+        switch ((fifo_control & FCR_TX_TRIGGER_MASK) >> FCR_TX_TRIGGER_SHIFT) {
+            case 1:  tx_low_water = 2; break;
+            case 2:  tx_low_water = 4; break;
+            case 3:  tx_low_water = 8; break;
+            default: tx_low_water = 0; break;
+        }
+    }
+
+    if ((int_enable & IER_LINE_STATUS) != 0 && line_status) {
+        return IIR_LINE_STATUS;
+    } else if ((int_enable & IER_CHAR_MATCH) != 0 && match_pending) {
+        return IIR_CHAR_MATCH;
+    } else if ((int_enable & IER_RX_DATA) != 0 && rx_fill >= rx_trigger) {
+        return IIR_RX_DATA;
+    } else if ((int_enable & IER_RX_DATA) != 0 && rx_timeout) {
+        return IIR_RX_TIMEOUT;
+    } else if ((int_enable & IER_TX_EMPTY) != 0 && tx_fill <= tx_low_water) {
+        return IIR_TX_EMPTY;
+    }
+    return IIR_NONE;
+}
+
+// Divisor and fraction from an autobaud count over 2^bit_shift bit
+// times at the given oversampling ratio. A count too long for a 16-bit
+// divisor gets the slowest rate the registers hold, not a wrapped one.
+inline void autobaud_rate(sc_uint<24> count, sc_uint<3> bit_shift, sc_uint<5> osr_ratio,
+                          sc_uint<16>& divisor, sc_uint<8>& fraction) {
+    // Divide by bit times and by samples per bit
+    sc_uint<3> shift = bit_shift;
+    if (osr_ratio == 16) {
+        shift += 4;
+    } else if (osr_ratio == 8) {
+        shift += 3;
+    } else {
+        shift += 2;
+    }
+
+    sc_uint<24> quotient = count >> shift;
+    if (quotient > 0xFFFF) {
+        divisor = 0xFFFF;
+        fraction = 0xFF;
+    } else {
+        divisor = quotient;
+        fraction = (count << (8 - shift)) & 0xFF;
+    }
+}
+
+#endif
@@ -0,0 +1,906 @@
+/**************************************************************
+ * File Name: uart_core.cpp
+ * Authors: Luke Guenthner, Nguyen Nguyen, Marcellus Wilson
+ * Date: 10/16/2026
+ *
+ * Fused controller + datapath implementation
+ **************************************************************/
+#include "uart_core.h"
+#include <iostream>
+
+using namespace std;
+
+// One thread for both directions. The frame state and the registers it
+// drives live together, so the bit the FSM picks this iteration is the
+// bit on tx_out when the iteration ends, and a received bit is checked
+// and stored in the iteration its vote completes. Reset drives the
+// ports too, so the memory map never sees a level from before it.
+void uart_core::process() {
+    {
+        HLS_DEFINE_PROTOCOL("reset");
+        reset();
+        write_outputs();
+    }
+
+    {
+        HLS_DEFINE_PROTOCOL("wait");
+        wait();
+    }
+
+    while(true) {
+        // Read inputs
+        {
+            HLS_DEFINE_PROTOCOL("input");
+            read_inputs();
+        }
+
+        // Check if memory write is active
+        if(!in_mem_we) {
+            if(in_start) {
+                {
+                    HLS_DEFINE_PROTOCOL("start");
+                    reset();
+                }
+            } else {
+                {
+                    HLS_DEFINE_PROTOCOL("core_ops");
+                    compute();
+                }
+
+                {
+                    HLS_DEFINE_PROTOCOL("output");
+                    write_outputs();
+                }
+            }
+        }
+
+        // Wait for next cycle
+        {
+            HLS_DEFINE_PROTOCOL("wait");
+            wait();
+        }
+
+#if !UART_SINGLE_CYCLE
+        // Additional wait for processing time
+        {
+            HLS_DEFINE_PROTOCOL("wait");
+            wait();
+        }
+#endif
+    }
+}
+
+void uart_core::reset() {
+    // Reset transmitter
+    tx_state = CORE_TX_IDLE;
+    tx_holding_register = 0;
+    tx_holding_valid = false;
+    tx_shift_register = 0;
+    tx_bit_count = 0;
+    tx_stop_count = 0;
+    tx_parity_acc = false;
+    tx_addr_bit = false;
+    tx_line = true;  // Idle state is high
+    tx_fetch_wait = CORE_TX_FETCH_LATENCY;
+    tx_tick = false;
+    tx_os_count = 0;
+    de_active = false;
+    de_guard_count = 0;
+    ts_tx_toggle = false;
+
+    // Reset receiver
+    rx_shift_register = 0;
+    rx_frame_tags = 0;
+    rx_frame_zero = false;
+    rx_parity_acc = false;
+    rx_break_hold = false;
+    rx_addr_bit = false;
+    rx_addressed = false;
+    rx_ring_moved = false;
+    rx_frame_stamp = 0;
+
+    // Reset buffer pointers
+    tx_buf_head = 0;
+    tx_buf_tail = 0;
+    rx_buf_head = 0;
+    rx_buf_tail = 0;
+
+    // Reset baud rate generation
+    baud_divider = 0x0003;  // Default baud rate divisor
+    baud_fraction = 0;
+    baud_counter = 0;
+    baud_frac_acc = 0;
+    sample_tick = false;
+    osr_ratio = 16;
+
+    // Reset receiver front-end
+    rx_sync = 3;     // Line idles high
+    rx_samples = 7;
+    rx_sampling = false;
+    rx_os_count = 0;
+    rx_frame_bits = 0;
+
+    // Reset autobaud detector
+    rx_control = 0;
+    autobaud_state = AB_OFF;
+    autobaud_count = 0;
+    autobaud_edges = 0;
+    autobaud_prev = true;
+    autobaud_step = 0;
+    autobaud_divisor = 0;
+    autobaud_fraction = 0;
+
+    // Reset flow control
+    modem_control = 0;
+    rts_threshold = RTS_THRESHOLD_DEFAULT;
+    cts_sync = 3;
+    rts_state = true;
+    tx_flow_char = 0;
+    tx_xoff_sent = false;
+    rx_peer_xoff = false;
+
+    // Reset interrupt logic
+    fifo_control = 0x01;
+    int_enable = 0;
+    rx_timeout_count = 0;
+
+    // Reset character match
+    match_char = 0;
+    match_valid = false;
+    match_ring_index = 0;
+    out_match_pending = false;
+
+    // Reset frame check engine
+    crc_mode = CRC_MODE_OFF;
+    tx_crc_reg = 0;
+    tx_crc_clear = false;
+    rx_crc_reg = 0;
+    rx_crc_clear = false;
+
+    // Reset byte-stuffing framers
+    tx_framing = FRAMING_OFF;
+    slip_tx_escape = 0;
+    slip_tx_end = false;
+    rx_framing = FRAMING_OFF;
+    slip_rx_escape = false;
+    slip_rx_staged = false;
+    slip_rx_stage = 0;
+    slip_rx_stage_stamp = 0;
+
+    // Reset configuration
+    parity_enabled = false;
+    parity_even = true;
+    data_bits = 8;
+    stop_bits = 1;
+    break_control = false;
+    multidrop = false;
+    station_addr = 0;
+    station_mask = 0xFF;
+    rs485_control = 0;
+
+    // Reset output signals
+    out_tx_buffer_full = false;
+    out_rx_buffer_empty = true;
+    out_parity_error = false;
+    out_framing_error = false;
+    out_overrun_error = false;
+    out_rx_timeout = false;
+    out_irq = false;
+    out_int_id = IIR_NONE;
+    out_tx_out = 1;
+    out_rts_out = true;
+    out_de_out = false;
+    out_addr = TX_BUFFER_START;
+    out_dp_data_in = 0;
+    out_dp_addr = 0;
+    out_dp_write_enable = false;
+    out_dp_ts_data = 0;
+}
+
+void uart_core::read_inputs() {
+    // Read all input ports
+    in_start = start.read();
+    in_mem_we = mem_we.read();
+    in_rx_in = rx_in.read();
+    in_cts_in = cts_in.read();
+    in_ts_count = ts_count.read();
+    in_data_in = data_in.read();
+    in_tx_head = tx_head.read();
+    in_rx_tail = rx_tail.read();
+    in_cfg_line_control = cfg_line_control.read();
+    in_cfg_baud_divisor = cfg_baud_divisor.read();
+    in_cfg_baud_fraction = cfg_baud_fraction.read();
+    in_cfg_fifo_control = cfg_fifo_control.read();
+    in_cfg_rx_control = cfg_rx_control.read();
+    in_cfg_modem_control = cfg_modem_control.read();
+    in_cfg_rts_threshold = cfg_rts_threshold.read();
+    in_cfg_int_enable = cfg_int_enable.read();
+    in_cfg_station = cfg_station.read();
+    in_cfg_rs485_control = cfg_rs485_control.read();
+    in_cfg_crc_control = cfg_crc_control.read();
+    in_cfg_framing_control = cfg_framing_control.read();
+    in_cfg_match_char = cfg_match_char.read();
+}
+
+void uart_core::write_outputs() {
+    // Write all output ports
+    tx_buffer_full.write(out_tx_buffer_full);
+    rx_buffer_empty.write(out_rx_buffer_empty);
+    parity_error.write(out_parity_error);
+    framing_error.write(out_framing_error);
+    overrun_error.write(out_overrun_error);
+    rx_timeout.write(out_rx_timeout);
+    irq.write(out_irq);
+    int_id.write(out_int_id);
+    match_pending.write(out_match_pending);
+    match_index.write(match_ring_index);
+    ts_tx_event.write(ts_tx_toggle);
+    tx_idle.write(tx_state == CORE_TX_IDLE && !tx_frame_ready());
+    tx_out.write(out_tx_out);
+    rts_out.write(out_rts_out);
+    de_out.write(out_de_out);
+    addr.write(out_addr);
+    dp_data_in.write(out_dp_data_in);
+    dp_addr.write(out_dp_addr);
+    dp_write_enable.write(out_dp_write_enable);
+    dp_ts_data.write(out_dp_ts_data);
+    tx_tail.write(tx_buf_tail);
+    rx_head.write(rx_buf_head);
+    tx_crc.write(crc_result(tx_crc_reg, crc_mode));
+    rx_crc.write(crc_result(rx_crc_reg, crc_mode));
+}
+
+void uart_core::compute() {
+    // Reset logic, active low like the thread reset
+    if (!rst.read()) {
+        reset();
+        return;
+    }
+
+    // Write enable is a single-cycle pulse
+    out_dp_write_enable = false;
+    rx_ring_moved = false;
+
+    // The host advances these through the data port
+    tx_buf_head = in_tx_head;
+    if (in_rx_tail != rx_buf_tail) {
+        rx_buf_tail = in_rx_tail;
+        rx_ring_moved = true;
+    }
+
+    update_configuration();
+    update_crc_configuration();
+    update_baud_tick();
+
+    // Transmitter: fetch, then step the frame with the fetched byte
+    // already visible, so a byte that lands in the holding register can
+    // start its frame on the same tick
+    update_tx_fetch();
+    if (tx_tick) {
+        step_tx();
+    }
+
+    // Break holds the line low over whatever the transmitter is doing;
+    // the frame logic keeps running so clearing the bit resumes cleanly
+    out_tx_out = tx_line && !break_control;
+    out_de_out = (rs485_control & RSC_DE_ENABLE) != 0 && de_active;
+    out_tx_buffer_full = (tx_buf_head ^ tx_buf_tail) == TX_BUFFER_SIZE;
+
+    // Receiver
+    update_rx_sampler();
+    out_rx_buffer_empty = (rx_buf_head == rx_buf_tail);
+
+    update_flow_control();
+    update_rx_timeout();
+    update_char_match();
+    update_interrupts();
+
+    // Autobaud write-back shares the memory write port with RX
+    update_autobaud();
+}
+
+// Decode the configuration shadows. The memory map only changes them
+// when a register is written, so configuration takes no cycles on the
+// memory port.
+void uart_core::update_configuration() {
+    sc_uint<DATA_W> lcr = in_cfg_line_control;
+
+    data_bits = (lcr & LCR_DATA_BITS_MASK) + 5;
+    stop_bits = ((lcr & LCR_STOP_BITS) != 0) ? 2 : 1;
+    parity_enabled = (lcr & LCR_PARITY_ENABLE) != 0;
+    parity_even = (lcr & LCR_PARITY_EVEN) != 0;
+    break_control = (lcr & LCR_BREAK_CONTROL) != 0;
+
+    // Multidrop address filter
+    rx_control = in_cfg_rx_control;
+    multidrop = (rx_control & RXC_MULTIDROP) != 0;
+    station_addr = in_cfg_station.range(7, 0);
+    station_mask = in_cfg_station.range(15, 8);
+
+    // Baud rate divisor, fraction and oversampling ratio
+    baud_divider = in_cfg_baud_divisor;
+    baud_fraction = in_cfg_baud_fraction;
+    switch (rx_control & RXC_OSR_MASK) {
+        case 1:  osr_ratio = 8;  break;
+        case 2:  osr_ratio = 4;  break;
+        default: osr_ratio = 16; break;
+    }
+
+    // Flow control, FIFO control, interrupt enable and RS-485
+    modem_control = in_cfg_modem_control;
+    rts_threshold = in_cfg_rts_threshold;
+    fifo_control = in_cfg_fifo_control;
+    int_enable = in_cfg_int_enable;
+    match_char = in_cfg_match_char;
+    rs485_control = in_cfg_rs485_control;
+
+    // Byte-stuffing framers. Turning one off drops its partial state.
+    tx_framing = in_cfg_framing_control & FRC_TX_MASK;
+    rx_framing = (in_cfg_framing_control & FRC_RX_MASK) >> FRC_RX_SHIFT;
+    if (tx_framing != FRAMING_SLIP) {
+        slip_tx_escape = 0;
+        slip_tx_end = false;
+    }
+    if (rx_framing != FRAMING_SLIP) {
+        slip_rx_escape = false;
+        slip_rx_staged = false;
+    }
+}
+
+// A new mode restarts both CRCs, a clear toggle restarts its own
+void uart_core::update_crc_configuration() {
+    sc_uint<2> mode = in_cfg_crc_control & CRC_MODE_MASK;
+    bool tx_clear = (in_cfg_crc_control & CRC_TX_CLEAR) != 0;
+    bool rx_clear = (in_cfg_crc_control & CRC_RX_CLEAR) != 0;
+
+    if (mode != crc_mode || tx_clear != tx_crc_clear) {
+        tx_crc_reg = crc_seed(mode);
+    }
+    if (mode != crc_mode || rx_clear != rx_crc_clear) {
+        rx_crc_reg = crc_seed(mode);
+    }
+
+    crc_mode = mode;
+    tx_crc_clear = tx_clear;
+    rx_crc_clear = rx_clear;
+}
+
+// One fractional divider feeds both directions. Every divider period is
+// a sample tick for the receiver, and every osr_ratio of them is a TX
+// bit period, so the line rate is clock / (divisor * osr_ratio).
+void uart_core::update_baud_tick() {
+    sample_tick = false;
+    tx_tick = false;
+
+    if (baud_counter == 0) {
+        sc_uint<9> acc = baud_frac_acc + baud_fraction;
+        baud_frac_acc = acc.range(7, 0);
+
+        if (baud_divider > 1) {
+            baud_counter = baud_divider - 1 + acc[8];
+        } else {
+            baud_counter = acc[8];
+        }
+        sample_tick = true;
+    } else {
+        baud_counter--;
+    }
+
+    if (sample_tick) {
+        if (tx_os_count >= osr_ratio - 1) {
+            tx_os_count = 0;
+            tx_tick = true;
+        } else {
+            tx_os_count++;
+        }
+    }
+}
+
+// TX ring prefetch. The fetch address always sits on the tail, so the
+// holding register refills as soon as the memory read has settled,
+// with no load handshake. The wait restarts whenever the tail moves or
+// the ring is empty, which covers a host push landing mid-read.
+void uart_core::update_tx_fetch() {
+    out_addr = TX_BUFFER_START + tx_buf_tail.range(TX_FIFO_DEPTH_LOG2 - 1, 0);
+
+    if (tx_buf_head == tx_buf_tail) {
+        tx_fetch_wait = CORE_TX_FETCH_LATENCY;
+    } else if (tx_fetch_wait != 0) {
+        tx_fetch_wait--;
+    } else if (!tx_holding_valid) {
+        tx_holding_register = in_data_in;
+        tx_holding_valid = true;
+        tx_buf_tail = tx_buf_tail + 1;
+        tx_fetch_wait = CORE_TX_FETCH_LATENCY;
+    }
+}
+
+// A frame is due for the holding register or for a pending SLIP code
+bool uart_core::tx_frame_ready() {
+    return tx_holding_valid || tx_flow_char != 0 || slip_tx_escape != 0 || slip_tx_end;
+}
+
+// Move the next byte into the shift register and put the start bit on
+// the line. A queued XON/XOFF goes first. With SLIP framing the second
+// half of an escape, then a frame END, go out before the holding
+// register is taken.
+void uart_core::start_tx_frame() {
+    if (tx_flow_char != 0) {
+        tx_shift_register = tx_flow_char;
+        tx_flow_char = 0;
+        tx_addr_bit = false;
+    } else if (slip_tx_escape != 0) {
+        tx_shift_register = slip_tx_escape;
+        slip_tx_escape = 0;
+        tx_addr_bit = false;
+    } else if (slip_tx_end) {
+        tx_shift_register = SLIP_END;
+        slip_tx_end = false;
+        tx_addr_bit = false;
+    } else {
+        tx_holding_valid = false;
+
+        // Fold the frame's data bits into the TX CRC, before escaping
+        sc_uint<8> byte = tx_holding_register.range(7, 0);
+        byte &= (1 << data_bits) - 1;
+        tx_crc_reg = crc_update(tx_crc_reg, byte, crc_mode);
+
+        // Bit 8 of a THR write marks an address byte, or with SLIP
+        // framing the last byte of a packet
+        tx_addr_bit = tx_holding_register[8];
+
+        if (tx_framing == FRAMING_SLIP) {
+            slip_tx_end = tx_addr_bit;
+            tx_addr_bit = false;
+
+            slip_tx_escape = slip_escape(byte);
+            if (slip_tx_escape != 0) {
+                byte = SLIP_ESC;
+            }
+        }
+
+        tx_shift_register = byte;
+    }
+
+    tx_bit_count = 0;
+    tx_stop_count = 0;
+    tx_parity_acc = false;
+    tx_line = false;
+    de_active = true;
+    tx_state = CORE_TX_START;
+}
+
+// TX frame FSM, one step per bit period. The state names the bit that
+// is on the line, and each step drives the next bit directly.
+void uart_core::step_tx() {
+    // Auto-CTS, through the same two-flop synchronizer as rx_in. A
+    // frame already on the line always finishes. A received XOFF holds
+    // the transmitter the same way, but our own XON/XOFF always goes.
+    bool xon_xoff = (modem_control & MCR_XON_XOFF) != 0;
+    bool cts_ok = ((modem_control & MCR_AUTO_FLOW) == 0 || cts_sync[1]) &&
+                  !(xon_xoff && rx_peer_xoff);
+    cts_ok = cts_ok || tx_flow_char != 0;
+    bool lead = (rs485_control & RSC_DE_ENABLE) != 0 && !de_active;
+
+    switch (tx_state.to_uint()) {
+        case CORE_TX_IDLE:
+            // Keep driving the bus for the guard time after the last
+            // stop bit, then turn it around
+            if (de_guard_count != 0) {
+                de_guard_count--;
+            } else {
+                de_active = false;
+            }
+
+            if (tx_frame_ready() && cts_ok) {
+                if (lead) {
+                    // The driver goes on a bit period ahead of the start bit
+                    de_active = true;
+                    tx_state = CORE_TX_LEAD;
+                } else {
+                    start_tx_frame();
+                }
+            }
+            break;
+
+        case CORE_TX_LEAD:
+            start_tx_frame();
+            break;
+
+        case CORE_TX_START:
+        case CORE_TX_DATA:
+            if (tx_state == CORE_TX_DATA && tx_bit_count >= data_bits) {
+                // Last data bit done, parity slot or stop bit next
+                if (parity_enabled || multidrop) {
+                    if (multidrop) {
+                        tx_line = tx_addr_bit;
+                    } else {
+                        tx_line = parity_even ? tx_parity_acc : !tx_parity_acc;
+                    }
+                    tx_state = CORE_TX_PARITY;
+                } else {
+                    tx_line = true;
+                    tx_state = CORE_TX_STOP;
+                }
+            } else {
+                // Send data bits (LSB first)
+                tx_line = tx_shift_register[0];
+                tx_parity_acc = tx_parity_acc ^ tx_shift_register[0];
+                tx_shift_register = tx_shift_register >> 1;
+                tx_bit_count++;
+                tx_state = CORE_TX_DATA;
+            }
+            break;
+
+        case CORE_TX_PARITY:
+            tx_line = true;
+            tx_state = CORE_TX_STOP;
+            break;
+
+        case CORE_TX_STOP:
+            tx_stop_count++;
+            if (tx_stop_count < stop_bits) {
+                // Second stop bit
+                break;
+            }
+
+            // Last stop bit done, TX timestamp event
+            ts_tx_toggle = !ts_tx_toggle;
+
+            if (tx_frame_ready() && cts_ok) {
+                // Back-to-back: next start bit follows this stop bit
+                start_tx_frame();
+            } else {
+                de_guard_count = (rs485_control & RSC_GUARD_MASK) >> RSC_GUARD_SHIFT;
+                tx_state = CORE_TX_IDLE;
+            }
+            break;
+
+        default:
+            tx_line = true;
+            tx_state = CORE_TX_IDLE;
+            break;
+    }
+}
+
+// Oversampling receiver front-end, as in the split datapath, except
+// that the voted bit goes straight to receive_bit() instead of across
+// an rx_tick to the controller and back
+void uart_core::update_rx_sampler() {
+    // Two-flop synchronizer on the asynchronous serial input. With
+    // echo suppression the receiver sees mark while our own driver
+    // is on the bus.
+    bool echo = (rs485_control & RSC_ECHO_SUPPRESS) != 0 && out_de_out;
+    rx_sync[1] = rx_sync[0];
+    rx_sync[0] = (bool)in_rx_in || echo;
+
+    // The detector owns the line while autobaud is armed
+    if (autobaud_state != AB_OFF) {
+        rx_sampling = false;
+        return;
+    }
+    
+    // Between sample ticks the frame in progress is kept as it is
+    if (!sample_tick) {
+        return;
+    }
+
+    rx_samples = (rx_samples << 1) | rx_sync[1];
+
+    // After a break, wait for the line to return to mark before
+    // hunting for the next start bit
+    if (rx_break_hold) {
+        if (rx_samples[0] == 1) {
+            rx_break_hold = false;
+        }
+        return;
+    }
+
+    if (!rx_sampling) {
+        // Falling edge: previous sample high, this one low
+        if (rx_samples[1] == 1 && rx_samples[0] == 0) {
+            rx_sampling = true;
+            rx_frame_stamp = in_ts_count;  // RX timestamp
+            rx_os_count = 0;
+            rx_frame_bits = 0;
+        }
+        return;
+    }
+
+    if (rx_os_count >= osr_ratio - 1) {
+        rx_os_count = 0;
+    } else {
+        rx_os_count++;
+    }
+
+    if (rx_os_count == (osr_ratio >> 1) + 1) {
+        bool voted = sample_vote(rx_samples);
+
+        if (rx_frame_bits == 0 && voted) {
+            // Not a real start bit, go back to hunting for an edge
+            rx_sampling = false;
+            return;
+        }
+
+        receive_bit(voted);
+    }
+}
+
+// Handle one voted bit. rx_frame_bits is the position of the bit in
+// the frame, so no separate RX state is needed: 0 is the start bit,
+// then data_bits data bits, the parity slot if any, then the stop bit.
+void uart_core::receive_bit(bool bit) {
+    sc_uint<4> parity_slot = data_bits + 1;
+    bool has_parity = parity_enabled || multidrop;
+    sc_uint<4> stop_slot = parity_slot + (has_parity ? 1 : 0);
+
+    if (rx_frame_bits == 0) {
+        rx_frame_tags = 0;
+        rx_frame_zero = true;
+        rx_parity_acc = false;
+        rx_shift_register = 0;
+
+        // A new frame clears the previous frame's line status
+        out_parity_error = false;
+        out_framing_error = false;
+        out_overrun_error = false;
+    } else if (rx_frame_bits < parity_slot) {
+        // Data bits arrive LSB first
+        rx_shift_register[rx_frame_bits - 1] = bit;
+        rx_parity_acc = rx_parity_acc ^ bit;
+        if (bit) {
+            rx_frame_zero = false;
+        }
+    } else if (has_parity && rx_frame_bits == parity_slot) {
+        if (bit) {
+            rx_frame_zero = false;
+        }
+
+        if (multidrop) {
+            // Address bit in place of parity
+            rx_addr_bit = bit;
+        } else if (bit != (parity_even ? rx_parity_acc : !rx_parity_acc)) {
+            out_parity_error = true;
+            rx_frame_tags[RX_TAG_PARITY - 8] = 1;
+        }
+    } else if (rx_frame_bits == stop_slot) {
+        // Only the first stop bit is checked, the receiver can resync
+        // on the next start edge during a second one
+        if (!bit) {
+            out_framing_error = true;
+            rx_frame_tags[RX_TAG_FRAMING - 8] = 1;
+
+            // Line low for the whole frame: a break, not a character
+            if (rx_frame_zero) {
+                rx_frame_tags[RX_TAG_BREAK - 8] = 1;
+                rx_break_hold = true;
+            }
+        }
+
+        store_rx_frame();
+        rx_sampling = false;
+    }
+
+    rx_frame_bits++;
+}
+
+// Put a finished frame in the RX ring, tagged with its errors
+void uart_core::store_rx_frame() {
+    // Multidrop: an address frame selects or deselects this station and
+    // is not stored, data for another station is dropped. A break is a
+    // line condition and always goes in.
+    bool store = true;
+    if (multidrop && rx_frame_tags[RX_TAG_BREAK - 8] == 0) {
+        if (rx_addr_bit) {
+            rx_addressed = ((rx_shift_register ^ station_addr) & station_mask) == 0;
+            store = false;
+        } else {
+            store = rx_addressed;
+        }
+    }
+
+    // In-band flow control: an intact XON/XOFF sets the peer's request
+    // for our transmitter and never enters the ring
+    if (store && (modem_control & MCR_XON_XOFF) != 0 && rx_frame_tags == 0 &&
+        is_flow_char(rx_shift_register)) {
+        rx_peer_xoff = (rx_shift_register == XOFF_CHAR);
+        store = false;
+    }
+
+    sc_uint<RX_ENTRY_W> entry = 0;
+    entry.range(7, 0) = rx_shift_register;
+    entry.range(RX_ENTRY_W - 1, 8) = rx_frame_tags;
+    sc_uint<32> stamp = rx_frame_stamp;
+
+    // SLIP de-framer, as in the split datapath
+    if (store && rx_framing == FRAMING_SLIP) {
+        store = slip_decode(rx_shift_register, rx_frame_tags, rx_frame_stamp,
+                            slip_rx_escape, slip_rx_staged,
+                            slip_rx_stage, slip_rx_stage_stamp, entry, stamp);
+    }
+
+    if (!store) {
+        // Not for this station, flow control, or held by the de-framer
+    } else if ((rx_buf_head ^ rx_buf_tail) == RX_BUFFER_SIZE) {
+        // Buffer full, flag overrun and drop the byte
+        out_overrun_error = true;
+    } else {
+        out_dp_write_enable = true;
+        out_dp_addr = RX_BUFFER_START + rx_buf_head.range(RX_FIFO_DEPTH_LOG2 - 1, 0);
+        out_dp_data_in = entry;
+        out_dp_ts_data = stamp;
+
+        // Every byte that enters the ring goes into the RX CRC
+        rx_crc_reg = crc_update(rx_crc_reg, entry.range(7, 0), crc_mode);
+
+        // Latch the slot of the newest match character
+        if (match_char[8] && entry.range(7, 0) == match_char.range(7, 0)) {
+            match_valid = true;
+            match_ring_index = rx_buf_head;
+        }
+
+        rx_buf_head = rx_buf_head + 1;
+        rx_ring_moved = true;
+    }
+}
+
+// Hardware flow control. CTS is synchronized here and sampled by the
+// TX FSM at frame boundaries. Auto-RTS drops at rts_threshold entries
+// and rises again once the ring has drained to half of that.
+void uart_core::update_flow_control() {
+    cts_sync[1] = cts_sync[0];
+    cts_sync[0] = (bool)in_cts_in;
+
+    bool auto_flow = (modem_control & MCR_AUTO_FLOW) != 0;
+
+    sc_uint<RX_PTR_W> rx_fill = rx_buf_head - rx_buf_tail;
+    if (rx_fill >= rts_threshold) {
+        rts_state = false;
+    } else if (rx_fill <= (rts_threshold >> 1)) {
+        rts_state = true;
+    }
+
+    if (auto_flow) {
+        out_rts_out = rts_state;
+    } else {
+        out_rts_out = (modem_control & MCR_RTS) != 0;
+    }
+
+    // In-band flow control on the same hysteresis: each change of
+    // rts_state queues one XOFF or XON ahead of the TX ring
+    bool xon_xoff = (modem_control & MCR_XON_XOFF) != 0;
+    queue_flow_char(xon_xoff, !rts_state, tx_flow_char, tx_xoff_sent);
+    if (!xon_xoff) {
+        rx_peer_xoff = false;
+    }
+}
+
+// Character timeout, four idle character times with bytes waiting
+void uart_core::update_rx_timeout() {
+    sc_uint<RX_PTR_W> rx_fill = rx_buf_head - rx_buf_tail;
+    sc_uint<4> frame_bits = 1 + data_bits + ((parity_enabled || multidrop) ? 1 : 0) + stop_bits;
+    sc_uint<10> limit = (osr_ratio * frame_bits) << 2;
+
+    if (rx_fill == 0 || rx_sampling || rx_ring_moved) {
+        rx_timeout_count = 0;
+        out_rx_timeout = false;
+    } else if (sample_tick && !out_rx_timeout) {
+        if (rx_timeout_count >= limit - 1) {
+            out_rx_timeout = true;
+        } else {
+            rx_timeout_count++;
+        }
+    }
+}
+
+// Character match, pending until the host pops past the matched byte
+void uart_core::update_char_match() {
+    sc_uint<RX_PTR_W> rx_fill = rx_buf_head - rx_buf_tail;
+    sc_uint<RX_PTR_W> offset = match_ring_index - rx_buf_tail;
+
+    if (!match_valid || offset >= rx_fill) {
+        match_valid = false;
+    }
+
+    out_match_pending = match_valid;
+}
+
+// Interrupt generation, same sources and priorities as the split
+// datapath. Both ring levels are local here.
+void uart_core::update_interrupts() {
+    sc_uint<RX_PTR_W> rx_fill = rx_buf_head - rx_buf_tail;
+    sc_uint<TX_PTR_W> tx_fill = tx_buf_head - tx_buf_tail;
+
+    bool line_status = out_parity_error || out_framing_error || out_overrun_error;
+
+    out_int_id = interrupt_id(int_enable, fifo_control, line_status,
+                              out_match_pending, out_rx_timeout, rx_fill, tx_fill);
+    out_irq = (out_int_id != IIR_NONE);
+}
+
+// Automatic baud-rate detection, as in the split datapath
+void uart_core::update_autobaud() {
+    sc_uint<2> mode = (rx_control & RXC_AUTOBAUD_MASK) >> RXC_AUTOBAUD_SHIFT;
+    bool level = rx_sync[1];
+    bool falling = autobaud_prev && !level;
+    bool rising = !autobaud_prev && level;
+    autobaud_prev = level;
+
+    switch (autobaud_state) {
+        case AB_OFF:
+            if (mode != 0) {
+                autobaud_state = AB_WAIT_EDGE;
+            }
+            break;
+
+        case AB_WAIT_EDGE:
+            if (mode == 0) {
+                autobaud_state = AB_OFF;
+            } else if (falling) {
+                autobaud_count = 1;
+                autobaud_edges = 0;
+                autobaud_state = AB_MEASURE;
+            }
+            break;
+
+        case AB_MEASURE: {
+            bool done = false;
+            sc_uint<3> shift;
+
+            if (mode == 1) {
+                done = rising;
+                shift = 0;              // 1 bit time
+            } else {
+                if (falling) {
+                    autobaud_edges++;
+                }
+                done = falling && autobaud_edges == ((mode == 2) ? 4 : 2);
+                shift = 3;              // 8 bit times
+            }
+
+            if (done) {
+                autobaud_rate(autobaud_count, shift, osr_ratio,
+                              autobaud_divisor, autobaud_fraction);
+                autobaud_step = 0;
+                autobaud_state = AB_WRITEBACK;
+            } else if (autobaud_count != 0xFFFFFF) {
+                autobaud_count++;  // Saturates on a stuck line
+            }
+            break;
+        }
+
+        case AB_WRITEBACK:
+            // One register per cycle, yield to an RX store
+            if (!out_dp_write_enable) {
+                out_dp_write_enable = true;
+                switch (autobaud_step) {
+                    case 0:
+                        out_dp_addr = BAUD_RATE_LOW;
+                        out_dp_data_in = autobaud_divisor.range(7, 0);
+                        break;
+                    case 1:
+                        out_dp_addr = BAUD_RATE_HIGH;
+                        out_dp_data_in = autobaud_divisor.range(15, 8);
+                        break;
+                    case 2:
+                        out_dp_addr = BAUD_RATE_FRAC;
+                        out_dp_data_in = autobaud_fraction;
+                        break;
+                    default:
+                        out_dp_addr = RX_CONTROL_REG;
+                        out_dp_data_in = rx_control & ~RXC_AUTOBAUD_MASK;
+                        autobaud_state = AB_DONE;
+                        break;
+                }
+                autobaud_step++;
+            }
+            break;
+
+        default:
+            // Wait for the cleared mode bits to read back
+            if (mode == 0) {
+                autobaud_state = AB_OFF;
+            }
+            break;
+    }
+}
@@ -0,0 +1,331 @@
+/**************************************************************
+ * File Name: uart_core.h
+ * Authors: Luke Guenthner, Nguyen Nguyen, Marcellus Wilson
+ * Date: 10/16/2026
+ *
+ * Fused controller + datapath. One thread holds both the frame
+ * FSMs and the datapath registers, so a control decision acts on
+ * the line in the iteration it is made instead of crossing two
+ * registered handshakes. Drop-in for the controller/datapath pair
+ * behind the memory map, selected with UART_FUSED_CORE.
+ **************************************************************/
+
+#ifndef __UART_CORE_H__
+#define __UART_CORE_H__
+
+#include "systemc.h"
+#include "stratus_hls.h"
+#include "sizes.h"
+#include "uart_common.h"
+
+// Fused TX frame states, the bit currently on the line
+#define CORE_TX_IDLE   0
+#define CORE_TX_LEAD   1  // RS-485 driver on, start bit next
+#define CORE_TX_START  2
+#define CORE_TX_DATA   3
+#define CORE_TX_PARITY 4
+#define CORE_TX_STOP   5
+
+// Iterations from a TX fetch address change to its data on data_in
+#define CORE_TX_FETCH_LATENCY 2
+
+SC_MODULE(uart_core) {
+    // Clock and reset
+    sc_in<bool> clk;                        // Port 0
+    sc_in<bool> rst;                        // Port 1
+
+    // Status outputs
+    sc_out<bool> tx_buffer_full;            // Port 2
+    sc_out<bool> rx_buffer_empty;           // Port 3
+    sc_out<bool> parity_error;              // Port 4
+    sc_out<bool> framing_error;             // Port 5
+    sc_out<bool> overrun_error;             // Port 6
+    sc_out<bool> rx_timeout;                // Port 7 - Character timeout pending
+    sc_out<bool> irq;                       // Port 8 - Interrupt request
+    sc_out<sc_uint<4>> int_id;              // Port 9 - Interrupt identification code
+    sc_out<bool> match_pending;             // Port 10 - Matched byte still in the RX ring
+    sc_out<sc_uint<RX_PTR_W>> match_index;  // Port 11 - RX ring pointer of the matched byte
+    sc_out<bool> ts_tx_event;               // Port 12 - Toggles on each TX stop bit end
+    sc_out<bool> tx_idle;                   // Port 13 - No frame on the line or waiting to start
+
+    // External interface
+    sc_in<bool> rx_in;                      // Port 14 - Serial input
+    sc_out<bool> tx_out;                    // Port 15 - Serial output
+    sc_in<bool> cts_in;                     // Port 16 - Clear to send (high = send)
+    sc_out<bool> rts_out;                   // Port 17 - Request to send (high = ready)
+    sc_out<bool> de_out;                    // Port 18 - RS-485 driver enable
+
+    // Interface to memory map
+    sc_in<sc_uint<DATA_W>> data_in;         // Port 19 - TX ring fetch data
+    sc_out<sc_uint<ADDR_W>> addr;           // Port 20 - TX ring fetch address
+    sc_out<sc_uint<RX_ENTRY_W>> dp_data_in; // Port 21 - Data to write to memory
+    sc_out<sc_uint<ADDR_W>> dp_addr;        // Port 22 - Address to write to
+    sc_out<bool> dp_write_enable;           // Port 23 - Write enable signal
+    sc_out<sc_uint<32>> dp_ts_data;         // Port 24 - Start-bit stamp of the stored entry
+    sc_in<sc_uint<32>> ts_count;            // Port 25 - Memory map timestamp counter
+    sc_out<sc_uint<32>> tx_crc;             // Port 26 - CRC of the bytes sent
+    sc_out<sc_uint<32>> rx_crc;             // Port 27 - CRC of the bytes stored
+
+    // Configuration shadows from the memory map
+    sc_in<sc_uint<DATA_W>> cfg_line_control; // Port 28 - Line control register
+    sc_in<sc_uint<16>> cfg_baud_divisor;    // Port 29 - Baud divisor, high:low
+    sc_in<sc_uint<8>> cfg_baud_fraction;    // Port 30 - Baud divisor fraction
+    sc_in<sc_uint<DATA_W>> cfg_fifo_control; // Port 31 - FIFO control register
+    sc_in<sc_uint<DATA_W>> cfg_rx_control;  // Port 32 - Receiver control register
+    sc_in<sc_uint<DATA_W>> cfg_modem_control; // Port 33 - Modem control register
+    sc_in<sc_uint<DATA_W>> cfg_rts_threshold; // Port 34 - Auto-RTS threshold
+    sc_in<sc_uint<DATA_W>> cfg_int_enable;  // Port 35 - Interrupt enable register
+    sc_in<sc_uint<16>> cfg_station;         // Port 36 - Station mask:address
+    sc_in<sc_uint<DATA_W>> cfg_rs485_control; // Port 37 - RS-485 control register
+    sc_in<sc_uint<DATA_W>> cfg_crc_control; // Port 38 - CRC mode and clear toggles
+    sc_in<sc_uint<DATA_W>> cfg_framing_control; // Port 39 - Byte-stuffing framer modes
+    sc_in<sc_uint<DATA_W>> cfg_match_char;  // Port 40 - Match character and enable
+
+    // Ring pointers shared with the memory map
+    sc_in<sc_uint<TX_PTR_W>> tx_head;       // Port 41 - Host TX write pointer
+    sc_in<sc_uint<RX_PTR_W>> rx_tail;       // Port 42 - Host RX read pointer
+    sc_out<sc_uint<TX_PTR_W>> tx_tail;      // Port 43 - TX read pointer
+    sc_out<sc_uint<RX_PTR_W>> rx_head;      // Port 44 - RX write pointer
+
+    // Memory management inputs
+    sc_in<bool> start;                      // Port 45 - Start signal
+    sc_in<bool> mem_we;                     // Port 46 - Memory write enable
+
+    // Main process method
+    void process();
+
+    // Core methods
+    void reset();
+    void read_inputs();
+    void write_outputs();
+    void compute();
+
+    // Processing methods
+    void update_configuration();
+    void update_baud_tick();
+    void update_tx_fetch();
+    void step_tx();
+    void start_tx_frame();
+    bool tx_frame_ready();
+    void update_rx_sampler();
+    void receive_bit(bool bit);
+    void store_rx_frame();
+    void update_flow_control();
+    void update_rx_timeout();
+    void update_char_match();
+    void update_interrupts();
+    void update_autobaud();
+    void update_crc_configuration();
+
+    // Helper methods
+
+    // Transmitter
+    sc_uint<3> tx_state;                    // Bit on the line
+    sc_uint<DATA_W> tx_holding_register;    // Next byte, prefetched from the ring
+    bool tx_holding_valid;                  // Holding register has a byte
+    sc_uint<DATA_W> tx_shift_register;      // Byte being sent
+    sc_uint<4> tx_bit_count;                // Data bits sent this frame
+    sc_uint<2> tx_stop_count;               // Stop bits sent this frame
+    bool tx_parity_acc;                     // XOR of the data bits sent
+    bool tx_addr_bit;                       // 9th bit to send (multidrop)
+    bool tx_line;                           // Line level from the frame logic
+    sc_uint<2> tx_fetch_wait;               // Iterations until data_in is valid
+    bool tx_tick;                           // One TX bit period elapsed
+    bool de_active;                         // Driver enable level
+    bool ts_tx_toggle;                      // ts_tx_event level
+    sc_uint<4> de_guard_count;              // Bit periods left before DE drops
+
+    // Receiver
+    sc_uint<8> rx_shift_register;           // Byte being received
+    sc_uint<3> rx_frame_tags;               // Error tags for the frame in progress
+    bool rx_frame_zero;                     // Every bit of the frame so far was 0
+    bool rx_parity_acc;                     // XOR of the data bits received
+    bool rx_break_hold;                     // Break seen, waiting for mark
+    bool rx_addr_bit;                       // 9th bit of the frame (multidrop)
+    bool rx_addressed;                      // Last address frame matched (multidrop)
+    bool rx_ring_moved;                     // RX ring pushed or popped this iteration
+    sc_uint<32> rx_frame_stamp;             // ts_count at this frame's start edge
+
+    // Buffer pointers
+    sc_uint<TX_PTR_W> tx_buf_head;          // Head pointer for TX buffer (host owned)
+    sc_uint<TX_PTR_W> tx_buf_tail;          // Tail pointer for TX buffer in memory
+    sc_uint<RX_PTR_W> rx_buf_head;          // Head pointer for RX buffer in memory
+    sc_uint<RX_PTR_W> rx_buf_tail;          // Tail pointer for RX buffer (host owned)
+
+    // Baud rate generation
+    sc_uint<16> baud_divider;               // Baud rate divisor value
+    sc_uint<8> baud_fraction;               // Fractional divisor in 1/256 steps
+    sc_uint<16> baud_counter;               // Counter for baud rate generation
+    sc_uint<8> baud_frac_acc;               // Fraction accumulator
+    bool sample_tick;                       // Oversampling tick this cycle
+    sc_uint<5> osr_ratio;                   // Samples per bit (16, 8 or 4)
+    sc_uint<4> tx_os_count;                 // Sample ticks into the current TX bit
+
+    // Oversampling receiver front-end
+    sc_uint<2> rx_sync;                     // Input synchronizer
+    sc_uint<3> rx_samples;                  // Last three samples of rx_in
+    bool rx_sampling;                       // Inside a frame
+    sc_uint<4> rx_os_count;                 // Sample ticks since the bit edge
+    sc_uint<4> rx_frame_bits;               // Bits delivered in this frame
+
+    // Automatic baud-rate detection
+    sc_uint<DATA_W> rx_control;             // Receiver control register copy
+    sc_uint<3> autobaud_state;              // Detector state
+    sc_uint<24> autobaud_count;             // Iterations since the start edge
+    sc_uint<3> autobaud_edges;              // Falling edges seen after the start
+    bool autobaud_prev;                     // Line level last cycle
+    sc_uint<2> autobaud_step;               // Register write-back step
+    sc_uint<16> autobaud_divisor;           // Measured divisor
+    sc_uint<8> autobaud_fraction;           // Measured divisor fraction
+
+    // Hardware flow control
+    sc_uint<DATA_W> modem_control;          // Modem control register copy
+    sc_uint<DATA_W> rts_threshold;          // RX fill level that drops auto-RTS
+    sc_uint<2> cts_sync;                    // CTS synchronizer
+    bool rts_state;                         // Auto-RTS level with hysteresis
+    sc_uint<8> tx_flow_char;                // XON/XOFF waiting to go out, 0 if none
+    bool tx_xoff_sent;                      // Last flow character sent was XOFF
+    bool rx_peer_xoff;                      // Last flow character received was XOFF
+
+    // Interrupt logic
+    sc_uint<DATA_W> fifo_control;           // FIFO control register copy
+    sc_uint<DATA_W> int_enable;             // Interrupt enable register copy
+    sc_uint<10> rx_timeout_count;           // Idle sample ticks with data waiting
+
+    // Character match
+    sc_uint<DATA_W> match_char;             // Match register copy, bit 8 enables
+    bool match_valid;                       // match_ring_index holds a match
+    sc_uint<RX_PTR_W> match_ring_index;     // RX ring pointer of the last match
+
+    // Frame check engine, one running CRC per direction
+    sc_uint<2> crc_mode;                    // CRC mode from CRC_CONTROL_REG
+    sc_uint<32> tx_crc_reg;                 // CRC over the bytes sent
+    bool tx_crc_clear;                      // Last TX clear toggle seen
+    sc_uint<32> rx_crc_reg;                 // CRC over the bytes stored in the RX ring
+    bool rx_crc_clear;                      // Last RX clear toggle seen
+
+    // Byte-stuffing framers
+    sc_uint<2> tx_framing;                  // TX framing mode
+    sc_uint<8> slip_tx_escape;              // Second half of an escape still to send, 0 if none
+    bool slip_tx_end;                       // END still to send after the last byte
+    sc_uint<2> rx_framing;                  // RX framing mode
+    bool slip_rx_escape;                    // ESC received, next byte is escaped
+    bool slip_rx_staged;                    // slip_rx_stage holds a decoded byte
+    sc_uint<RX_ENTRY_W> slip_rx_stage;      // Decoded byte waiting to see if it ends the frame
+    sc_uint<32> slip_rx_stage_stamp;        // Start-bit stamp of slip_rx_stage
+
+    // Configuration registers
+    bool parity_enabled;                    // Parity enabled flag
+    bool parity_even;                       // Even parity (1) or odd parity (0)
+    sc_uint<4> data_bits;                   // Number of data bits (5-8)
+    sc_uint<2> stop_bits;                   // Number of stop bits (1, 2)
+    bool break_control;                     // Force tx_out low (LCR break)
+    bool multidrop;                         // 9-bit mode, parity slot carries the address bit
+    sc_uint<8> station_addr;                // Multidrop station address
+    sc_uint<8> station_mask;                // Multidrop address compare mask
+    sc_uint<DATA_W> rs485_control;          // RS-485 control register copy
+
+    // Internal input values
+    sc_bit in_start;
+    sc_bit in_mem_we;
+    sc_bit in_rx_in;
+    sc_bit in_cts_in;
+    sc_uint<32> in_ts_count;
+    sc_uint<DATA_W> in_data_in;
+    sc_uint<TX_PTR_W> in_tx_head;
+    sc_uint<RX_PTR_W> in_rx_tail;
+    sc_uint<DATA_W> in_cfg_line_control;
+    sc_uint<16> in_cfg_baud_divisor;
+    sc_uint<8> in_cfg_baud_fraction;
+    sc_uint<DATA_W> in_cfg_fifo_control;
+    sc_uint<DATA_W> in_cfg_rx_control;
+    sc_uint<DATA_W> in_cfg_modem_control;
+    sc_uint<DATA_W> in_cfg_rts_threshold;
+    sc_uint<DATA_W> in_cfg_int_enable;
+    sc_uint<16> in_cfg_station;
+    sc_uint<DATA_W> in_cfg_rs485_control;
+    sc_uint<DATA_W> in_cfg_crc_control;
+    sc_uint<DATA_W> in_cfg_framing_control;
+    sc_uint<DATA_W> in_cfg_match_char;
+
+    // Internal output values
+    sc_bit out_tx_buffer_full;
+    sc_bit out_rx_buffer_empty;
+    sc_bit out_parity_error;
+    sc_bit out_framing_error;
+    sc_bit out_overrun_error;
+    sc_bit out_rx_timeout;
+    sc_bit out_irq;
+    sc_uint<4> out_int_id;
+    sc_bit out_match_pending;
+    sc_bit out_tx_out;
+    sc_bit out_rts_out;
+    sc_bit out_de_out;
+    sc_uint<ADDR_W> out_addr;
+    sc_uint<RX_ENTRY_W> out_dp_data_in;
+    sc_uint<ADDR_W> out_dp_addr;
+    sc_bit out_dp_write_enable;
+    sc_uint<32> out_dp_ts_data;
+
+    SC_CTOR(uart_core) {
+        SC_THREAD(process);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, false);
+    }
+
+#ifdef NC_SYSTEMC
+public:
+    void ncsc_replace_names() {
+        // Replace port names for simulation
+        ncsc_replace_name(clk, "clk");                          // Port 0
+        ncsc_replace_name(rst, "rst");                          // Port 1
+        ncsc_replace_name(tx_buffer_full, "tx_buffer_full");    // Port 2
+        ncsc_replace_name(rx_buffer_empty, "rx_buffer_empty");  // Port 3
+        ncsc_replace_name(parity_error, "parity_error");        // Port 4
+        ncsc_replace_name(framing_error, "framing_error");      // Port 5
+        ncsc_replace_name(overrun_error, "overrun_error");      // Port 6
+        ncsc_replace_name(rx_timeout, "rx_timeout");            // Port 7
+        ncsc_replace_name(irq, "irq");                          // Port 8
+        ncsc_replace_name(int_id, "int_id");                    // Port 9
+        ncsc_replace_name(match_pending, "match_pending");      // Port 10
+        ncsc_replace_name(match_index, "match_index");          // Port 11
+        ncsc_replace_name(ts_tx_event, "ts_tx_event");          // Port 12
+        ncsc_replace_name(tx_idle, "tx_idle");                  // Port 13
+        ncsc_replace_name(rx_in, "rx_in");                      // Port 14
+        ncsc_replace_name(tx_out, "tx_out");                    // Port 15
+        ncsc_replace_name(cts_in, "cts_in");                    // Port 16
+        ncsc_replace_name(rts_out, "rts_out");                  // Port 17
+        ncsc_replace_name(de_out, "de_out");                    // Port 18
+        ncsc_replace_name(data_in, "data_in");                  // Port 19
+        ncsc_replace_name(addr, "addr");                        // Port 20
+        ncsc_replace_name(dp_data_in, "dp_data_in");            // Port 21
+        ncsc_replace_name(dp_addr, "dp_addr");                  // Port 22
+        ncsc_replace_name(dp_write_enable, "dp_write_enable");  // Port 23
+        ncsc_replace_name(dp_ts_data, "dp_ts_data");            // Port 24
+        ncsc_replace_name(ts_count, "ts_count");                // Port 25
+        ncsc_replace_name(tx_crc, "tx_crc");                    // Port 26
+        ncsc_replace_name(rx_crc, "rx_crc");                    // Port 27
+        ncsc_replace_name(cfg_line_control, "cfg_line_control");// Port 28
+        ncsc_replace_name(cfg_baud_divisor, "cfg_baud_divisor");// Port 29
+        ncsc_replace_name(cfg_baud_fraction, "cfg_baud_fraction");// Port 30
+        ncsc_replace_name(cfg_fifo_control, "cfg_fifo_control");// Port 31
+        ncsc_replace_name(cfg_rx_control, "cfg_rx_control");    // Port 32
+        ncsc_replace_name(cfg_modem_control, "cfg_modem_control");// Port 33
+        ncsc_replace_name(cfg_rts_threshold, "cfg_rts_threshold");// Port 34
+        ncsc_replace_name(cfg_int_enable, "cfg_int_enable");    // Port 35
+        ncsc_replace_name(cfg_station, "cfg_station");          // Port 36
+        ncsc_replace_name(cfg_rs485_control, "cfg_rs485_control");// Port 37
+        ncsc_replace_name(cfg_crc_control, "cfg_crc_control");  // Port 38
+        ncsc_replace_name(cfg_framing_control, "cfg_framing_control");// Port 39
+        ncsc_replace_name(cfg_match_char, "cfg_match_char");    // Port 40
+        ncsc_replace_name(tx_head, "tx_head");                  // Port 41
+        ncsc_replace_name(rx_tail, "rx_tail");                  // Port 42
+        ncsc_replace_name(tx_tail, "tx_tail");                  // Port 43
+        ncsc_replace_name(rx_head, "rx_head");                  // Port 44
+        ncsc_replace_name(start, "start");                      // Port 45
+        ncsc_replace_name(mem_we, "mem_we");                    // Port 46
+    }
+#endif
+};
+
+#endif